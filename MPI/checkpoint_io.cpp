@@ -0,0 +1,370 @@
+// Parallel Checkpointing with MPI-IO (collective writes, aligned file views, asynchronous helper thread)
+// Concept: The usual checkpoint is "gather to rank 0, rank 0 writes": all data funnels through one process's
+// memory, one network link and one file stream, so checkpoint time grows with the number of ranks.
+// MPI-IO lets every rank write its own part of ONE shared file:
+//   1. Layout: a header (magic, rank count, per-rank offset and size) followed by one region per rank. Each
+//      region starts on an ALIGNMENT boundary (file-system block / stripe size) so no two ranks write the
+//      same block, which would force read-modify-write and lock ping-pong on parallel file systems.
+//   2. File view: each rank sets its view displacement to its region, so it addresses its data from offset 0.
+//   3. Collective write (MPI_File_write_at_all): the MPI library sees every rank's request at once and can merge
+//      them into large contiguous writes through a few aggregator ranks (ROMIO "collective buffering").
+//   4. Asynchronous checkpoint: a helper thread writes a snapshot copy of the state while the main thread keeps
+//      computing (needs MPI_THREAD_MULTIPLE; the helper uses its own duplicated communicator so its collectives
+//      never interleave with the main thread's).
+// Benchmark: gather-to-root vs independent MPI-IO vs collective MPI-IO bandwidth, then compute+checkpoint time
+// with blocking vs asynchronous checkpoints.
+
+#include <mpi.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <climits>
+#include <unistd.h> // fsync, unlink
+
+constexpr char CHECKPOINT_MAGIC[8] = {'C', 'K', 'P', 'T', 'M', 'P', 'I', '1'};
+constexpr size_t IO_CHUNK = size_t(1) << 30; // MPI counts are int: write at most 1 GiB per call
+
+inline uint64_t align_up(uint64_t x, uint64_t a) { return (x + a - 1) / a * a; }
+
+uint64_t fnv1a(const void* data, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001B3ull;
+    return h;
+}
+
+// --- Checkpoint library ---
+class MpiCheckpoint {
+public:
+    // alignment: region boundary in bytes (use the stripe size on Lustre/GPFS; 1 MiB is a safe default)
+    MpiCheckpoint(MPI_Comm comm, uint64_t alignment = 1u << 20) : alignment_(alignment) {
+        MPI_Comm_dup(comm, &comm_); // Private communicator: safe to use from a helper thread
+        MPI_Comm_rank(comm_, &rank_);
+        MPI_Comm_size(comm_, &size_);
+        MPI_Info_create(&info_);
+        MPI_Info_set(info_, "romio_cb_write", "enable"); // Collective buffering (ROMIO); ignored elsewhere
+        MPI_Info_set(info_, "romio_cb_read", "enable");
+        MPI_Info_set(info_, "striping_unit", std::to_string(alignment).c_str());
+    }
+    ~MpiCheckpoint() {
+        MPI_Info_free(&info_);
+        MPI_Comm_free(&comm_);
+    }
+
+    // Every rank writes `bytes` (may differ per rank). collective = false uses independent MPI_File_write_at.
+    // File handles default to MPI_ERRORS_RETURN, so every call is checked; the result is agreed across ranks:
+    // true on all ranks only if every rank's data is on disk, false on all ranks otherwise.
+    bool write(const std::string& path, const void* data, uint64_t bytes, bool collective = true) {
+        std::vector<uint64_t> sizes(size_);
+        MPI_Allgather(&bytes, 1, MPI_UINT64_T, sizes.data(), 1, MPI_UINT64_T, comm_);
+        const std::vector<uint64_t> offsets = layout(sizes);
+
+        MPI_File fh;
+        // MPI_File_open is collective and fails on every rank together (e.g. unwritable directory)
+        if (!agree(MPI_File_open(comm_, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, info_, &fh) == MPI_SUCCESS))
+            return false;
+        // MPI_MODE_CREATE does not truncate: cut off any tail left by a larger earlier checkpoint
+        bool ok = MPI_File_set_size(fh, MPI_Offset(offsets[size_ - 1] + sizes[size_ - 1])) == MPI_SUCCESS;
+        if (rank_ == 0) { // Header: magic, rank count, alignment, then (offset, size) per rank
+            std::vector<uint64_t> header(3 + 2 * size_);
+            std::memcpy(&header[0], CHECKPOINT_MAGIC, 8);
+            header[1] = uint64_t(size_);
+            header[2] = alignment_;
+            for (int r = 0; r < size_; ++r) { header[3 + 2 * r] = offsets[r]; header[4 + 2 * r] = sizes[r]; }
+            ok &= MPI_File_write_at(fh, 0, header.data(), int(header.size() * 8), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+        }
+        ok &= MPI_File_set_view(fh, MPI_Offset(offsets[rank_]), MPI_BYTE, MPI_BYTE, "native", info_) == MPI_SUCCESS;
+        ok &= transfer(fh, const_cast<void*>(data), bytes, collective, true);
+        ok &= MPI_File_sync(fh) == MPI_SUCCESS; // Durable before we call the checkpoint complete
+        ok &= MPI_File_close(&fh) == MPI_SUCCESS;
+        return agree(ok);
+    }
+
+    // Restores this rank's region; false if the file does not match the communicator or the size
+    bool read(const std::string& path, void* data, uint64_t bytes) {
+        MPI_File fh;
+        if (!agree(MPI_File_open(comm_, path.c_str(), MPI_MODE_RDONLY, info_, &fh) == MPI_SUCCESS)) return false;
+        std::vector<uint64_t> header(3 + 2 * size_);
+        bool ok = MPI_File_read_at_all(fh, 0, header.data(), int(header.size() * 8), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS &&
+                  std::memcmp(&header[0], CHECKPOINT_MAGIC, 8) == 0 && header[1] == uint64_t(size_) &&
+                  header[4 + 2 * rank_] == bytes;
+        if (agree(ok)) {
+            ok &= MPI_File_set_view(fh, MPI_Offset(header[3 + 2 * rank_]), MPI_BYTE, MPI_BYTE, "native", info_) == MPI_SUCCESS;
+            ok &= transfer(fh, data, bytes, true, false);
+        }
+        ok &= MPI_File_close(&fh) == MPI_SUCCESS;
+        return agree(ok);
+    }
+
+private:
+    // Region r starts after the header and all earlier regions, each rounded up to the alignment
+    std::vector<uint64_t> layout(const std::vector<uint64_t>& sizes) const {
+        std::vector<uint64_t> offsets(size_);
+        uint64_t pos = align_up((3 + 2 * uint64_t(size_)) * 8, alignment_);
+        for (int r = 0; r < size_; ++r) {
+            offsets[r] = pos;
+            pos = align_up(pos + sizes[r], alignment_);
+        }
+        return offsets;
+    }
+
+    // True on every rank iff `ok` is true on every rank
+    bool agree(bool ok) const {
+        int local = ok, global;
+        MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LAND, comm_);
+        return global != 0;
+    }
+
+    // Collective calls must be made the same number of times on every rank, even by ranks with less data,
+    // so a failed chunk is recorded and the loop keeps going. Short transfers count as failures.
+    bool transfer(MPI_File fh, void* data, uint64_t bytes, bool collective, bool is_write) {
+        uint64_t calls = (bytes + IO_CHUNK - 1) / IO_CHUNK, max_calls;
+        MPI_Allreduce(&calls, &max_calls, 1, MPI_UINT64_T, MPI_MAX, comm_);
+        char* p = static_cast<char*>(data);
+        bool ok = true;
+        for (uint64_t i = 0; i < max_calls; ++i) {
+            const uint64_t off = std::min(bytes, i * IO_CHUNK);
+            const int count = int(std::min<uint64_t>(IO_CHUNK, bytes - off));
+            MPI_Status status;
+            int rc;
+            if (is_write && collective) rc = MPI_File_write_at_all(fh, MPI_Offset(off), p + off, count, MPI_BYTE, &status);
+            else if (is_write) rc = MPI_File_write_at(fh, MPI_Offset(off), p + off, count, MPI_BYTE, &status);
+            else rc = MPI_File_read_at_all(fh, MPI_Offset(off), p + off, count, MPI_BYTE, &status);
+            int done = 0;
+            if (rc == MPI_SUCCESS) MPI_Get_count(&status, MPI_BYTE, &done);
+            ok &= rc == MPI_SUCCESS && done == count;
+        }
+        return ok;
+    }
+
+    MPI_Comm comm_;
+    MPI_Info info_;
+    int rank_, size_;
+    const uint64_t alignment_;
+};
+
+// Writes a snapshot on a helper thread; start() returns as soon as the state has been copied
+class AsyncCheckpointer {
+public:
+    AsyncCheckpointer(MPI_Comm comm, bool threads_ok) : ckpt_(comm), threaded_(threads_ok) {
+        if (threaded_) helper_ = std::thread([this] { run(); });
+    }
+    ~AsyncCheckpointer() {
+        if (!threaded_) return;
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        helper_.join();
+    }
+
+    // Returns the result of the previous checkpoint (which start() waits for before reusing the snapshot)
+    bool start(const std::string& path, const void* data, uint64_t bytes) {
+        const bool previous_ok = wait(); // One checkpoint in flight: the snapshot buffer is reused
+        snapshot_.resize(bytes);
+        std::memcpy(snapshot_.data(), data, bytes);
+        if (!threaded_) { // No MPI_THREAD_MULTIPLE: fall back to a blocking write of the snapshot
+            last_ok_ = ckpt_.write(path, snapshot_.data(), bytes);
+            return previous_ok;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            path_ = path;
+            busy_ = true;
+        }
+        cv_.notify_all();
+        return previous_ok;
+    }
+
+    // Waits for the checkpoint in flight; false if the most recent checkpoint failed (agreed across ranks)
+    bool wait() {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [this] { return !busy_; });
+        return last_ok_;
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_);
+        while (true) {
+            cv_.wait(lock, [this] { return busy_ || stop_; });
+            if (stop_ && !busy_) return;
+            const std::string path = path_;
+            lock.unlock();
+            const bool ok = ckpt_.write(path, snapshot_.data(), snapshot_.size());
+            lock.lock();
+            last_ok_ = ok;
+            busy_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    MpiCheckpoint ckpt_;
+    const bool threaded_;
+    std::vector<char> snapshot_;
+    std::thread helper_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::string path_;
+    bool busy_ = false, stop_ = false, last_ok_ = true;
+};
+
+// --- Baseline: gather to rank 0, which writes everything ---
+bool gather_to_root_write(const std::string& path, const void* data, uint64_t bytes, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    if (bytes > uint64_t(INT_MAX)) MPI_Abort(comm, 1); // Gatherv counts are int
+    int count = int(bytes);
+    std::vector<int> counts(size), displs(size);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+    std::vector<char> all;
+    if (rank == 0) {
+        uint64_t total = 0;
+        for (int r = 0; r < size; ++r) { displs[r] = int(total); total += counts[r]; }
+        if (total > uint64_t(INT_MAX)) MPI_Abort(comm, 1);
+        all.resize(total);
+    }
+    MPI_Gatherv(data, count, MPI_BYTE, all.data(), counts.data(), displs.data(), MPI_BYTE, 0, comm);
+    int ok = 1;
+    if (rank == 0) {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        ok = f != nullptr;
+        if (f) {
+            ok = std::fwrite(all.data(), 1, all.size(), f) == all.size() && std::fflush(f) == 0 && fsync(fileno(f)) == 0;
+            ok &= std::fclose(f) == 0;
+        }
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, 0, comm); // Checkpoint is complete for everyone only when the root is done
+    return ok != 0;
+}
+
+// --- Benchmark ---
+
+// Stand-in for a solver step: a few streaming passes over the state
+void compute_step(std::vector<double>& state, int passes) {
+    for (int p = 0; p < passes; ++p)
+        for (double& x : state) x = x * 0.999999 + 1e-6;
+}
+
+// Checkpoint results are agreed across ranks, so every rank takes the same branch here
+void require(bool ok, const char* what, int rank) {
+    if (ok) return;
+    if (rank == 0) std::cout << "Checkpoint failed: " << what << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+template<typename Fn>
+double timed(MPI_Comm comm, Fn fn) {
+    MPI_Barrier(comm);
+    const double t0 = MPI_Wtime();
+    fn();
+    double local = MPI_Wtime() - t0, worst;
+    MPI_Allreduce(&local, &worst, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return worst;
+}
+
+int main(int argc, char** argv) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    const uint64_t mib_per_rank = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32;
+    const std::string dir = argc > 2 ? argv[2] : "/tmp";
+    const uint64_t bytes = mib_per_rank << 20;
+    const double total_gb = double(bytes) * size / 1e9;
+    const bool threads_ok = provided >= MPI_THREAD_MULTIPLE;
+
+    std::vector<double> state(bytes / sizeof(double));
+    for (size_t i = 0; i < state.size(); ++i) state[i] = double(rank) * 1e6 + double(i);
+
+    if (rank == 0) {
+        std::cout << "--- MPI-IO Checkpointing ---" << std::endl;
+        std::cout << "Ranks: " << size << ", state per rank: " << mib_per_rank << " MiB, total " << std::fixed
+                  << std::setprecision(3) << total_gb << " GB, directory " << dir << ", MPI_THREAD_MULTIPLE: "
+                  << (threads_ok ? "yes" : "no (async falls back to blocking)") << std::endl;
+        std::cout << "\nCheckpoint bandwidth (best of 3, includes sync to disk)" << std::endl;
+    }
+
+    const std::string gather_path = dir + "/ckpt_gather.bin";
+    const std::string mpiio_path = dir + "/ckpt_mpiio.bin";
+    { // MpiCheckpoint frees its communicator in the destructor, which must run before MPI_Finalize
+        MpiCheckpoint ckpt(MPI_COMM_WORLD);
+        struct Method { const char* name; int kind; };
+        for (const Method& m : {Method{"gather to rank 0 + fwrite", 0}, Method{"MPI-IO independent write_at", 1},
+                                Method{"MPI-IO collective write_at_all", 2}}) {
+            double best = 1e30;
+            for (int rep = 0; rep < 3; ++rep) {
+                best = std::min(best, timed(MPI_COMM_WORLD, [&] {
+                    if (m.kind == 0) require(gather_to_root_write(gather_path, state.data(), bytes, MPI_COMM_WORLD), m.name, rank);
+                    else require(ckpt.write(mpiio_path, state.data(), bytes, m.kind == 2), m.name, rank);
+                }));
+            }
+            if (rank == 0)
+                std::cout << "  " << std::left << std::setw(34) << m.name << std::right << std::setw(8)
+                          << std::setprecision(3) << best << " s" << std::setw(9) << std::setprecision(2)
+                          << total_gb / best << " GB/s" << std::endl;
+        }
+
+        // Restart check: read our region back and compare
+        std::vector<double> restored(state.size());
+        const bool read_ok = ckpt.read(mpiio_path, restored.data(), bytes);
+        int same = read_ok && fnv1a(restored.data(), bytes) == fnv1a(state.data(), bytes), all_same;
+        MPI_Allreduce(&same, &all_same, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        if (rank == 0) std::cout << "Restore from collective checkpoint matches: " << (all_same ? "Yes" : "NO") << std::endl;
+
+        // Overlap: STEPS solver steps with a checkpoint after each, blocking vs asynchronous
+        const int STEPS = 5, PASSES = 8;
+        const double compute_only = timed(MPI_COMM_WORLD, [&] {
+            for (int s = 0; s < STEPS; ++s) compute_step(state, PASSES);
+        });
+        const double blocking = timed(MPI_COMM_WORLD, [&] {
+            for (int s = 0; s < STEPS; ++s) {
+                compute_step(state, PASSES);
+                require(ckpt.write(mpiio_path, state.data(), bytes), "blocking checkpoint", rank);
+            }
+        });
+        double async;
+        {
+            AsyncCheckpointer async_ckpt(MPI_COMM_WORLD, threads_ok);
+            async = timed(MPI_COMM_WORLD, [&] {
+                for (int s = 0; s < STEPS; ++s) {
+                    compute_step(state, PASSES);
+                    // Snapshot, then keep computing; reports the previous checkpoint's result
+                    require(async_ckpt.start(mpiio_path, state.data(), bytes), "asynchronous checkpoint", rank);
+                }
+                require(async_ckpt.wait(), "asynchronous checkpoint", rank);
+            });
+        }
+        if (rank == 0) {
+            std::cout << "\n" << STEPS << " steps with a checkpoint after each" << std::endl;
+            std::cout << "  compute only:            " << std::setw(8) << std::setprecision(3) << compute_only << " s" << std::endl;
+            std::cout << "  blocking checkpoints:    " << std::setw(8) << blocking << " s  (checkpoint overhead "
+                      << std::setprecision(0) << 100.0 * (blocking - compute_only) / compute_only << "%)" << std::endl;
+            std::cout << "  asynchronous (helper):   " << std::setw(8) << std::setprecision(3) << async
+                      << " s  (checkpoint overhead " << std::setprecision(0)
+                      << 100.0 * (async - compute_only) / compute_only << "%)" << std::endl;
+            unlink(gather_path.c_str());
+            unlink(mpiio_path.c_str());
+        }
+    }
+    MPI_Finalize();
+    return 0;
+}
+
+// Build & Run (args: [MiB_per_rank=32] [directory=/tmp]):
+// mpicxx -std=c++17 -O2 -pthread checkpoint_io.cpp -o checkpoint_io
+// mpirun -np 4 ./checkpoint_io 32 /tmp        (Open MPI as root: add --allow-run-as-root --oversubscribe)
@@ -0,0 +1,416 @@
+// Hybrid MPI + Threads Task Runtime with Distributed Work Stealing (Unbalanced Tree Search)
+// Concept: Inside a rank, a work-stealing pool of worker threads (one deque each: owner pops newest, thieves take
+// oldest) keeps cores busy. Across ranks, the main thread of every rank is a communication thread (the only
+// thread that calls MPI, so MPI_THREAD_FUNNELED is enough):
+//   - When its pool runs dry it sends STEAL_REQUEST to a random victim rank.
+//   - A victim answers with WORK (a chunk of its oldest queued nodes - typically the largest subtrees) or NO_WORK.
+// Termination is the hard part: a rank can be idle while WORK is still in flight towards it. This uses
+// Safra's token algorithm (Dijkstra's ring, extended for asynchronous messages): each rank counts WORK messages
+// sent minus received and turns black when it receives work; rank 0 circulates a token that sums the counts.
+// A token returning white with a zero total proves that every rank is idle and no work is in transit.
+// Workload: Unbalanced Tree Search (UTS) binomial tree: the root has B0 children; every other node has M
+// children with probability Q, otherwise none. Node identity is a 64-bit hash (splitmix64 stands in for UTS's
+// SHA-1), so every run generates the same tree, but subtree sizes are wildly uneven and unknown in advance:
+// static partitioning leaves ranks idle while one grinds through a giant subtree.
+// Benchmark: static split of the root's children over ranks vs distributed work stealing, same tree.
+
+#include <mpi.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// --- UTS tree ---
+struct Node {
+    uint64_t hash;
+    uint32_t depth;
+    uint32_t pad = 0;
+};
+
+struct TreeParams {
+    int b0 = 2000;      // Root branching factor
+    double q = 0.12495; // Probability that a non-root node has children
+    int m = 8;          // Children of a non-leaf node; q * m < 1 keeps the tree finite
+    int work = 16;      // Extra hash rounds per node: the "computation" attached to each node
+};
+
+inline uint64_t mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline int num_children(const Node& n, const TreeParams& p) {
+    if (n.depth == 0) return p.b0;
+    const double u = double(n.hash >> 11) * (1.0 / 9007199254740992.0);
+    return u < p.q ? p.m : 0;
+}
+
+inline Node child(const Node& n, int i) { return {mix64(n.hash ^ (uint64_t(i + 1) * 0xD1B54A32D192ED03ull)), n.depth + 1}; }
+
+// --- Per-rank work-stealing pool ---
+// `pending` counts nodes that are queued OR being processed. Children are added before their parent is
+// retired, so pending only reaches 0 when the rank truly has no work left.
+class LocalPool {
+public:
+    LocalPool(int workers, const TreeParams& params) : params_(params), deques_(workers), processed_(workers) {
+        for (int i = 0; i < workers; ++i) threads_.emplace_back([this, i] { worker(i); });
+    }
+
+    ~LocalPool() {
+        stop_.store(true);
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    void push(const Node* nodes, size_t n) { // From the communication thread (received work / initial root)
+        pending_.fetch_add(long(n));
+        for (size_t i = 0; i < n; ++i) {
+            Deque& d = deques_[next_deque_++ % deques_.size()];
+            std::lock_guard<std::mutex> lock(d.m);
+            d.q.push_back(nodes[i]);
+        }
+        cv_.notify_all();
+    }
+
+    // Give away up to `max_nodes` of the oldest nodes from the fullest deque (at most half of it)
+    std::vector<Node> take_for_remote(size_t max_nodes) {
+        std::vector<Node> out;
+        Deque* best = nullptr;
+        size_t best_size = 0;
+        for (Deque& d : deques_) {
+            std::lock_guard<std::mutex> lock(d.m);
+            if (d.q.size() > best_size) { best_size = d.q.size(); best = &d; }
+        }
+        if (best == nullptr || best_size < 2) return out;
+        std::lock_guard<std::mutex> lock(best->m);
+        const size_t n = std::min(max_nodes, best->q.size() / 2);
+        out.assign(best->q.begin(), best->q.begin() + n);
+        best->q.erase(best->q.begin(), best->q.begin() + n);
+        pending_.fetch_sub(long(n));
+        return out;
+    }
+
+    bool idle() const { return pending_.load() == 0; }
+
+    uint64_t processed() const {
+        uint64_t s = 0;
+        for (const auto& p : processed_) s += p.count.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct alignas(64) Deque {
+        std::mutex m;
+        std::deque<Node> q;
+    };
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> count{0};
+    };
+
+    bool take(int id, Node& out) {
+        { // Own deque, newest first: depth-first, keeps the working set small
+            Deque& d = deques_[id];
+            std::lock_guard<std::mutex> lock(d.m);
+            if (!d.q.empty()) { out = d.q.back(); d.q.pop_back(); return true; }
+        }
+        for (size_t k = 1; k < deques_.size(); ++k) { // Local victims, oldest first: biggest subtrees
+            Deque& d = deques_[(id + k) % deques_.size()];
+            std::lock_guard<std::mutex> lock(d.m);
+            if (!d.q.empty()) { out = d.q.front(); d.q.pop_front(); return true; }
+        }
+        return false;
+    }
+
+    void worker(int id) {
+        std::vector<Node> children;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            Node n;
+            if (!take(id, n)) {
+                std::unique_lock<std::mutex> lock(idle_m_);
+                cv_.wait_for(lock, std::chrono::microseconds(200));
+                continue;
+            }
+            uint64_t h = n.hash;
+            for (int r = 0; r < params_.work; ++r) h = mix64(h); // Per-node computation
+            sink_.fetch_xor(h & 1, std::memory_order_relaxed);
+
+            const int k = num_children(n, params_);
+            if (k > 0) {
+                children.clear();
+                for (int i = 0; i < k; ++i) children.push_back(child(n, i));
+                pending_.fetch_add(k);
+                Deque& d = deques_[id];
+                std::lock_guard<std::mutex> lock(d.m);
+                d.q.insert(d.q.end(), children.begin(), children.end());
+            }
+            processed_[id].count.fetch_add(1, std::memory_order_relaxed);
+            pending_.fetch_sub(1); // Retire the parent only after its children are visible
+            if (k > 1) cv_.notify_all();
+        }
+    }
+
+    const TreeParams params_;
+    std::vector<Deque> deques_;
+    std::vector<Counter> processed_;
+    std::vector<std::thread> threads_;
+    std::atomic<long> pending_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> sink_{0};
+    std::atomic<size_t> next_deque_{0};
+    std::mutex idle_m_;
+    std::condition_variable cv_;
+};
+
+// --- Distributed stealing + Safra termination (all MPI calls on the rank's main thread) ---
+enum Tag { TAG_STEAL_REQUEST = 1, TAG_WORK, TAG_NO_WORK, TAG_TOKEN, TAG_TERMINATE };
+enum Color : long { WHITE = 0, BLACK = 1 };
+
+struct StealStats {
+    uint64_t requests_sent = 0, steals_ok = 0, chunks_given = 0, nodes_given = 0, token_rounds = 0;
+};
+
+StealStats run_distributed(LocalPool& pool, int rank, int size, size_t chunk) {
+    StealStats st;
+    std::mt19937 rng(1234 + rank);
+    long msg_count = 0;        // WORK messages sent minus received
+    Color color = WHITE;
+    bool steal_outstanding = false;
+    bool have_token = false, token_out = false;
+    long token[2] = {0, WHITE}; // {count, color}
+    bool terminated = false;
+    auto last_steal = std::chrono::steady_clock::now();
+
+    if (size == 1) { // Nothing to steal from and nobody to agree with
+        while (!pool.idle()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        return st;
+    }
+
+    std::vector<Node> buffer(chunk);
+    while (!terminated) {
+        bool progress = false;
+        int flag;
+        MPI_Status status;
+        while (MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status), flag) {
+            progress = true;
+            const int src = status.MPI_SOURCE;
+            switch (status.MPI_TAG) {
+            case TAG_STEAL_REQUEST: {
+                int dummy;
+                MPI_Recv(&dummy, 1, MPI_INT, src, TAG_STEAL_REQUEST, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                std::vector<Node> give = pool.take_for_remote(chunk);
+                if (give.empty()) {
+                    MPI_Send(&dummy, 1, MPI_INT, src, TAG_NO_WORK, MPI_COMM_WORLD);
+                } else {
+                    ++msg_count; // Counted before it can be received: Safra's invariant
+                    MPI_Send(give.data(), int(give.size() * sizeof(Node)), MPI_BYTE, src, TAG_WORK, MPI_COMM_WORLD);
+                    ++st.chunks_given;
+                    st.nodes_given += give.size();
+                }
+                break;
+            }
+            case TAG_WORK: {
+                int bytes;
+                MPI_Get_count(&status, MPI_BYTE, &bytes);
+                MPI_Recv(buffer.data(), bytes, MPI_BYTE, src, TAG_WORK, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                pool.push(buffer.data(), bytes / sizeof(Node));
+                --msg_count;
+                color = BLACK; // Received work: any token that already passed us may be stale
+                steal_outstanding = false;
+                ++st.steals_ok;
+                break;
+            }
+            case TAG_NO_WORK: {
+                int dummy;
+                MPI_Recv(&dummy, 1, MPI_INT, src, TAG_NO_WORK, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                steal_outstanding = false;
+                break;
+            }
+            case TAG_TOKEN:
+                MPI_Recv(token, 2, MPI_LONG, src, TAG_TOKEN, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                have_token = true;
+                break;
+            case TAG_TERMINATE: {
+                int dummy;
+                MPI_Recv(&dummy, 1, MPI_INT, src, TAG_TERMINATE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                terminated = true;
+                break;
+            }
+            }
+        }
+        if (terminated) break;
+
+        const bool idle = pool.idle();
+        // Thief: one request in flight at a time, with a short pause after a refusal to avoid request storms
+        if (idle && !steal_outstanding &&
+            std::chrono::steady_clock::now() - last_steal > std::chrono::microseconds(50)) {
+            int victim = int(rng() % (size - 1));
+            if (victim >= rank) ++victim;
+            int dummy = 0;
+            MPI_Send(&dummy, 1, MPI_INT, victim, TAG_STEAL_REQUEST, MPI_COMM_WORLD);
+            steal_outstanding = true;
+            last_steal = std::chrono::steady_clock::now();
+            ++st.requests_sent;
+        }
+
+        // Safra: the token only moves through idle ranks
+        if (idle && rank == 0 && !token_out) {
+            if (have_token && token[1] == WHITE && color == WHITE && token[0] + msg_count == 0) {
+                int dummy = 0;
+                for (int r = 1; r < size; ++r) MPI_Send(&dummy, 1, MPI_INT, r, TAG_TERMINATE, MPI_COMM_WORLD);
+                terminated = true;
+                break;
+            }
+            long fresh[2] = {0, WHITE}; // Start a (new) round
+            color = WHITE;
+            have_token = false;
+            token_out = true;
+            ++st.token_rounds;
+            MPI_Send(fresh, 2, MPI_LONG, 1, TAG_TOKEN, MPI_COMM_WORLD);
+        } else if (idle && rank == 0 && have_token) {
+            token_out = false; // Token came back: evaluate it on the next pass
+        } else if (idle && rank != 0 && have_token) {
+            token[0] += msg_count;
+            if (color == BLACK) token[1] = BLACK;
+            color = WHITE;
+            have_token = false;
+            MPI_Send(token, 2, MPI_LONG, (rank + 1) % size, TAG_TOKEN, MPI_COMM_WORLD);
+        }
+
+        if (!progress) std::this_thread::sleep_for(std::chrono::microseconds(idle ? 20 : 200));
+    }
+
+    // Drain: after TERMINATE nobody sends new requests, but ours may still await a reply and others' requests
+    // may still be arriving. Keep answering until every rank has its reply (non-blocking barrier completes).
+    MPI_Request barrier = MPI_REQUEST_NULL;
+    bool in_barrier = false;
+    for (;;) {
+        int flag;
+        MPI_Status status;
+        while (MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status), flag) {
+            int dummy;
+            MPI_Recv(&dummy, 1, MPI_INT, status.MPI_SOURCE, status.MPI_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            if (status.MPI_TAG == TAG_STEAL_REQUEST)
+                MPI_Send(&dummy, 1, MPI_INT, status.MPI_SOURCE, TAG_NO_WORK, MPI_COMM_WORLD);
+            else if (status.MPI_TAG == TAG_NO_WORK)
+                steal_outstanding = false;
+        }
+        if (!steal_outstanding && !in_barrier) {
+            MPI_Ibarrier(MPI_COMM_WORLD, &barrier);
+            in_barrier = true;
+        }
+        if (in_barrier) {
+            MPI_Test(&barrier, &flag, MPI_STATUS_IGNORE);
+            if (flag) break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    return st;
+}
+
+// --- Benchmark driver ---
+struct PhaseResult {
+    double seconds;
+    uint64_t total_nodes, max_rank_nodes;
+};
+
+PhaseResult report_phase(uint64_t local_nodes, double local_seconds, int size) {
+    PhaseResult r{};
+    MPI_Reduce(&local_seconds, &r.seconds, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    unsigned long long n = local_nodes, total = 0, mx = 0;
+    MPI_Reduce(&n, &total, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&n, &mx, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    r.total_nodes = total;
+    r.max_rank_nodes = mx;
+    (void)size;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    TreeParams params;
+    int workers = 2;
+    size_t chunk = 64;
+    if (argc > 1) workers = std::max(1, std::atoi(argv[1]));
+    if (argc > 2) params.b0 = std::atoi(argv[2]);
+    if (argc > 3) params.q = std::atof(argv[3]);
+    if (argc > 4) chunk = std::max(1, std::atoi(argv[4]));
+
+    const Node root{0x0123456789ABCDEFull, 0};
+    if (rank == 0) {
+        std::cout << "--- Hybrid MPI + Threads Work Stealing: UTS binomial tree ---" << std::endl;
+        std::cout << "Ranks: " << size << ", workers per rank: " << workers << ", tree: b0=" << params.b0
+                  << " q=" << params.q << " m=" << params.m << ", steal chunk " << chunk << " nodes"
+                  << (provided < MPI_THREAD_FUNNELED ? " (warning: MPI lacks FUNNELED support)" : "") << std::endl;
+    }
+
+    // Phase 1: static partition - root child i belongs to rank i % size, no stealing between ranks
+    uint64_t local_nodes;
+    double t0;
+    {
+        std::vector<Node> mine;
+        for (int i = rank; i < params.b0; i += size) mine.push_back(child(root, i));
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        LocalPool pool(workers, params);
+        pool.push(mine.data(), mine.size());
+        while (!pool.idle()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        local_nodes = pool.processed() + (rank == 0); // Count the root once
+    }
+    PhaseResult stat = report_phase(local_nodes, MPI_Wtime() - t0, size);
+
+    // Phase 2: everything starts at rank 0; the other ranks get work only by stealing it
+    StealStats st;
+    MPI_Barrier(MPI_COMM_WORLD);
+    t0 = MPI_Wtime();
+    {
+        LocalPool pool(workers, params);
+        if (rank == 0) pool.push(&root, 1);
+        st = run_distributed(pool, rank, size, chunk);
+        local_nodes = pool.processed();
+    }
+    PhaseResult steal = report_phase(local_nodes, MPI_Wtime() - t0, size);
+
+    unsigned long long sent = st.requests_sent, ok = st.steals_ok, given = st.nodes_given, total_sent, total_ok, total_given;
+    MPI_Reduce(&sent, &total_sent, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&ok, &total_ok, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&given, &total_given, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        auto line = [&](const char* name, const PhaseResult& r) {
+            const double avg = double(r.total_nodes) / size;
+            std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << r.total_nodes
+                      << " nodes" << std::setw(9) << std::fixed << std::setprecision(3) << r.seconds << " s"
+                      << std::setw(9) << std::setprecision(2) << r.total_nodes / r.seconds / 1e6 << " Mnodes/s"
+                      << "   busiest rank " << std::setprecision(2) << r.max_rank_nodes / avg << "x average" << std::endl;
+        };
+        std::cout << std::endl;
+        line("Static partition", stat);
+        line("Distributed stealing", steal);
+        std::cout << "Steal requests: " << total_sent << ", successful: " << total_ok << ", nodes moved: "
+                  << total_given << ", termination token rounds: " << st.token_rounds << std::endl;
+        std::cout << "Same tree size: " << (stat.total_nodes == steal.total_nodes ? "Yes" : "NO") << std::endl;
+    }
+    MPI_Finalize();
+    return 0;
+}
+
+// Build & Run (args: [workers_per_rank=2] [b0=2000] [q=0.12495] [steal_chunk=64]):
+// mpicxx -std=c++17 -O2 -pthread uts_work_stealing.cpp -o uts_work_stealing
+// mpirun -np 4 ./uts_work_stealing 2        (Open MPI as root: add --allow-run-as-root --oversubscribe)
@@ -0,0 +1,412 @@
+// Parallel Checksums and Hashing (hardware CRC32C, CRC combine, AVX2 64-bit hash, tree-mode hashing)
+// Concept: Verifying ingested files with one serial checksum runs at one core's speed, and a table-driven CRC
+// does not even reach that: every byte is a dependent table lookup. Three independent ways to go faster:
+//   1. Instruction: SSE4.2 crc32 does 8 bytes per instruction. Its latency is 3 cycles but its throughput is 1
+//      per cycle, so one thread runs THREE interleaved streams and merges them.
+//   2. Threads: CRC is linear over GF(2), so crc(A || B) = shift(crc(A), |B|) xor crc(B). Threads checksum
+//      their own slices; crc32c_combine() stitches the partial CRCs together in O(log |B|). Same value as serial.
+//   3. Hash shape: a 64-bit non-crypto hash (wide_hash64) with 4 independent 64-bit accumulator lanes maps onto
+//      one AVX2 register (32x32->64 multiplies, no 64-bit multiply needed). Tree mode hashes fixed-size leaves
+//      independently and then hashes the leaf digests, so the digest does not depend on the thread count.
+// Kernels are picked once at startup by CPU features, scalar fallbacks give bit-identical results.
+// Benchmarked per core (L2-resident buffer) and aggregate across threads (DRAM-sized buffer).
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+inline uint64_t read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+inline uint32_t read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// --- CRC32C (Castagnoli), reflected polynomial 0x82F63B78. Public values are pre/post-inverted as usual. ---
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+
+struct Crc32cTables {
+    uint32_t t[8][256]; // Slicing-by-8
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (c & 1 ? CRC32C_POLY : 0);
+            t[0][i] = c;
+        }
+        for (int s = 1; s < 8; ++s)
+            for (int i = 0; i < 256; ++i) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+    }
+};
+const Crc32cTables CRC_TABLES;
+
+uint32_t crc32c_bytewise(uint32_t crc, const uint8_t* p, size_t n) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = (crc >> 8) ^ CRC_TABLES.t[0][(crc ^ p[i]) & 0xFF];
+    return ~crc;
+}
+
+uint32_t crc32c_slice8(uint32_t crc, const uint8_t* p, size_t n) {
+    crc = ~crc;
+    const auto& t = CRC_TABLES.t;
+    for (; n >= 8; n -= 8, p += 8) {
+        const uint64_t v = read64(p) ^ crc;
+        crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+              t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+    }
+    for (; n > 0; --n) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return ~crc;
+}
+
+// GF(2) polynomial arithmetic modulo the CRC polynomial, in the reflected bit order (as in zlib's crc32_combine)
+uint32_t multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+struct X2nTable {
+    uint32_t x2n[32]; // x^(2^k) mod P
+    X2nTable() {
+        uint32_t p = 1u << 30; // x^1
+        for (int k = 0; k < 32; ++k) { x2n[k] = p; p = multmodp(p, p); }
+    }
+};
+const X2nTable X2N;
+
+// x^(n * 2^k) mod P; with k = 3 this is the operator "append n zero bytes"
+uint32_t x2nmodp(uint64_t n, int k) {
+    uint32_t p = 1u << 31; // x^0
+    for (; n; n >>= 1, ++k)
+        if (n & 1) p = multmodp(X2N.x2n[k & 31], p);
+    return p;
+}
+
+// CRC of A || B from crc(A), crc(B) and |B|
+uint32_t crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b) {
+    return multmodp(x2nmodp(len_b, 3), crc_a) ^ crc_b;
+}
+
+// Hardware CRC32C on a raw (non-inverted) register
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw_raw(uint32_t crc, const uint8_t* p, size_t n) {
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, p += 8) c = _mm_crc32_u64(c, read64(p));
+    for (; n > 0; --n) c = _mm_crc32_u8(uint32_t(c), *p++);
+    return uint32_t(c);
+}
+
+uint32_t crc32c_hw(uint32_t crc, const uint8_t* p, size_t n) { return ~crc32c_hw_raw(~crc, p, n); }
+
+// Three interleaved streams over consecutive STRIPE-byte pieces: three crc32 instructions in flight per cycle.
+// Raw CRCs are linear, so stream a's CRC shifted past b and c, xor b's shifted past c, xor c's is the whole CRC.
+constexpr size_t CRC_STRIPE = 4096;
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw3(uint32_t crc, const uint8_t* p, size_t n) {
+    static const uint32_t shift1 = x2nmodp(CRC_STRIPE, 3);     // x^(8 * STRIPE)
+    static const uint32_t shift2 = x2nmodp(2 * CRC_STRIPE, 3); // x^(16 * STRIPE)
+    uint64_t a = ~crc;
+    for (; n >= 3 * CRC_STRIPE; n -= 3 * CRC_STRIPE, p += 3 * CRC_STRIPE) {
+        uint64_t b = 0, c = 0;
+        for (size_t i = 0; i < CRC_STRIPE; i += 8) {
+            a = _mm_crc32_u64(a, read64(p + i));
+            b = _mm_crc32_u64(b, read64(p + CRC_STRIPE + i));
+            c = _mm_crc32_u64(c, read64(p + 2 * CRC_STRIPE + i));
+        }
+        a = multmodp(shift2, uint32_t(a)) ^ multmodp(shift1, uint32_t(b)) ^ uint32_t(c);
+    }
+    return ~crc32c_hw_raw(uint32_t(a), p, n);
+}
+
+// --- XXH64 (reference 64-bit non-crypto hash, scalar) ---
+constexpr uint64_t P64_1 = 0x9E3779B185EBCA87ull, P64_2 = 0xC2B2AE3D27D4EB4Full, P64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t P64_4 = 0x85EBCA77C2B2AE63ull, P64_5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t xxh64_round(uint64_t acc, uint64_t in) { return rotl64(acc + in * P64_2, 31) * P64_1; }
+inline uint64_t xxh64_merge(uint64_t h, uint64_t v) { return (h ^ xxh64_round(0, v)) * P64_1 + P64_4; }
+inline uint64_t avalanche64(uint64_t h) {
+    h ^= h >> 33; h *= P64_2;
+    h ^= h >> 29; h *= P64_3;
+    return h ^ (h >> 32);
+}
+
+uint64_t xxh64(const uint8_t* p, size_t n, uint64_t seed) {
+    const uint8_t* const end = p + n;
+    uint64_t h;
+    if (n >= 32) {
+        uint64_t v1 = seed + P64_1 + P64_2, v2 = seed + P64_2, v3 = seed, v4 = seed - P64_1;
+        for (; end - p >= 32; p += 32) {
+            v1 = xxh64_round(v1, read64(p));
+            v2 = xxh64_round(v2, read64(p + 8));
+            v3 = xxh64_round(v3, read64(p + 16));
+            v4 = xxh64_round(v4, read64(p + 24));
+        }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64_merge(xxh64_merge(xxh64_merge(xxh64_merge(h, v1), v2), v3), v4);
+    } else {
+        h = seed + P64_5;
+    }
+    h += n;
+    for (; end - p >= 8; p += 8) h = rotl64(h ^ xxh64_round(0, read64(p)), 27) * P64_1 + P64_4;
+    if (end - p >= 4) { h = rotl64(h ^ (read32(p) * P64_1), 23) * P64_2 + P64_3; p += 4; }
+    for (; p < end; ++p) h = rotl64(h ^ (*p * P64_5), 11) * P64_1;
+    return avalanche64(h);
+}
+
+// --- wide_hash64: 4-lane accumulate/scramble hash shaped for AVX2 (XXH3-style, not XXH3-compatible) ---
+// Per 32-byte stripe, lane l: dk = data[l] ^ key[l]; acc[l] += data[l ^ 1] + lo32(dk) * hi32(dk).
+// Every SCRAMBLE_STRIPES stripes: acc = (acc ^ acc >> 47 ^ key2[l]) * PRIME32 (a 64x32 multiply).
+// The final partial stripe is zero-padded; the length is mixed into the result.
+constexpr uint64_t WIDE_KEY[4] = {0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull};
+constexpr uint64_t WIDE_KEY2[4] = {0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull};
+constexpr uint32_t WIDE_PRIME32 = 0x9E3779B1u;
+constexpr int SCRAMBLE_STRIPES = 16;
+
+inline uint64_t wide_finish(const uint64_t acc[4], size_t n, uint64_t seed) {
+    uint64_t h = n * P64_1 ^ seed;
+    for (int l = 0; l < 4; ++l) h = (h ^ avalanche64(acc[l] ^ WIDE_KEY2[l])) * P64_2 + P64_4;
+    return avalanche64(h);
+}
+
+inline void wide_init(uint64_t acc[4], uint64_t seed) {
+    acc[0] = seed + P64_1; acc[1] = seed ^ P64_2; acc[2] = seed - P64_3; acc[3] = seed + P64_4;
+}
+
+uint64_t wide_hash64_scalar(const uint8_t* p, size_t n, uint64_t seed) {
+    uint64_t acc[4];
+    wide_init(acc, seed);
+    auto stripe = [&](const uint8_t* s) {
+        uint64_t d[4];
+        std::memcpy(d, s, 32);
+        for (int l = 0; l < 4; ++l) {
+            const uint64_t dk = d[l] ^ WIDE_KEY[l];
+            acc[l] += d[l ^ 1] + (dk & 0xFFFFFFFF) * (dk >> 32);
+        }
+    };
+    auto scramble = [&] {
+        for (int l = 0; l < 4; ++l) acc[l] = (acc[l] ^ (acc[l] >> 47) ^ WIDE_KEY2[l]) * WIDE_PRIME32;
+    };
+    size_t i = 0;
+    int count = 0;
+    for (; i + 32 <= n; i += 32) {
+        stripe(p + i);
+        if (++count == SCRAMBLE_STRIPES) { scramble(); count = 0; }
+    }
+    if (i < n) {
+        uint8_t last[32] = {};
+        std::memcpy(last, p + i, n - i);
+        stripe(last);
+    }
+    return wide_finish(acc, n, seed);
+}
+
+__attribute__((target("avx2")))
+inline __m256i wide_stripe_avx2(__m256i acc, const uint8_t* s, __m256i key) {
+    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    const __m256i dk = _mm256_xor_si256(d, key);
+    const __m256i product = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32)); // lo32 * hi32 per lane
+    const __m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)); // data[l ^ 1]
+    return _mm256_add_epi64(acc, _mm256_add_epi64(swapped, product));
+}
+
+__attribute__((target("avx2")))
+inline __m256i wide_scramble_avx2(__m256i acc, __m256i key2, __m256i prime) {
+    const __m256i x = _mm256_xor_si256(_mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47)), key2);
+    const __m256i lo = _mm256_mul_epu32(x, prime);
+    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)); // 64-bit x * 32-bit prime, mod 2^64
+}
+
+__attribute__((target("avx2")))
+uint64_t wide_hash64_avx2(const uint8_t* p, size_t n, uint64_t seed) {
+    alignas(32) uint64_t acc_mem[4];
+    wide_init(acc_mem, seed);
+    __m256i acc = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc_mem));
+    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(WIDE_KEY));
+    const __m256i key2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(WIDE_KEY2));
+    const __m256i prime = _mm256_set1_epi64x(WIDE_PRIME32);
+    size_t i = 0;
+    for (; i + 32 * SCRAMBLE_STRIPES <= n; i += 32 * SCRAMBLE_STRIPES) {
+        for (int s = 0; s < SCRAMBLE_STRIPES; ++s) acc = wide_stripe_avx2(acc, p + i + 32 * s, key);
+        acc = wide_scramble_avx2(acc, key2, prime);
+    }
+    for (; i + 32 <= n; i += 32) acc = wide_stripe_avx2(acc, p + i, key); // Fewer than SCRAMBLE_STRIPES left
+    if (i < n) {
+        alignas(32) uint8_t last[32] = {};
+        std::memcpy(last, p + i, n - i);
+        acc = wide_stripe_avx2(acc, last, key);
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(acc_mem), acc);
+    return wide_finish(acc_mem, n, seed);
+}
+
+// --- Dispatch ---
+struct Kernels {
+    uint32_t (*crc32c)(uint32_t, const uint8_t*, size_t);
+    uint64_t (*hash64)(const uint8_t*, size_t, uint64_t);
+    const char* crc_name;
+    const char* hash_name;
+};
+
+Kernels pick_kernels(bool allow_simd) {
+    Kernels k{crc32c_slice8, wide_hash64_scalar, "slice-by-8", "scalar"};
+    if (allow_simd && __builtin_cpu_supports("sse4.2")) { k.crc32c = crc32c_hw3; k.crc_name = "SSE4.2 x3"; }
+    if (allow_simd && __builtin_cpu_supports("avx2")) { k.hash64 = wide_hash64_avx2; k.hash_name = "AVX2"; }
+    return k;
+}
+
+// --- Multithreaded drivers ---
+
+template<typename Fn>
+void run_parts(int threads, Fn fn) {
+    std::vector<std::thread> ts;
+    for (int t = 1; t < threads; ++t) ts.emplace_back(fn, t);
+    fn(0);
+    for (auto& th : ts) th.join();
+}
+
+// Each thread checksums one contiguous slice; partial CRCs are folded left to right with crc32c_combine
+uint32_t crc32c_parallel(const Kernels& k, const uint8_t* p, size_t n, int threads) {
+    std::vector<uint32_t> part(threads);
+    std::vector<size_t> len(threads);
+    const size_t per = (n + threads - 1) / threads;
+    run_parts(threads, [&](int t) {
+        const size_t b = std::min(n, t * per), e = std::min(n, b + per);
+        len[t] = e - b;
+        part[t] = k.crc32c(0, p + b, e - b);
+    });
+    uint32_t crc = part[0];
+    for (int t = 1; t < threads; ++t) crc = crc32c_combine(crc, part[t], len[t]);
+    return crc;
+}
+
+// Tree mode: leaf i = hash64(leaf bytes, seed = i); root = xxh64(leaf digests, seed = total length).
+// Leaf size is fixed, so threads only change who computes which leaf, never the digest.
+constexpr size_t LEAF = 64 * 1024;
+
+uint64_t tree_hash(const Kernels& k, const uint8_t* p, size_t n, int threads) {
+    const size_t leaves = std::max<size_t>(1, (n + LEAF - 1) / LEAF);
+    std::vector<uint64_t> digest(leaves);
+    run_parts(threads, [&](int t) {
+        // Contiguous leaf ranges per thread: each thread streams through its own part of the buffer
+        const size_t per = (leaves + threads - 1) / threads;
+        const size_t lb = std::min(leaves, t * per), le = std::min(leaves, lb + per);
+        for (size_t i = lb; i < le; ++i) {
+            const size_t off = i * LEAF;
+            digest[i] = k.hash64(p + off, std::min(LEAF, n - off), i);
+        }
+    });
+    return xxh64(reinterpret_cast<const uint8_t*>(digest.data()), leaves * sizeof(uint64_t), n);
+}
+
+// --- Benchmark ---
+
+using Clock = std::chrono::steady_clock;
+
+// Best-of-reps GB/s of fn() over `bytes` bytes per call
+template<typename Fn>
+double gbps(size_t bytes, int reps, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - t0).count());
+    }
+    return bytes / best / 1e9;
+}
+
+volatile uint64_t sink; // Keeps benchmarked results alive
+
+int main() {
+    std::cout << "--- Parallel Checksums and Hashing ---" << std::endl;
+
+    // Known answers: CRC32C("123456789") = 0xE3069283, XXH64("") = 0xEF46DB3751D8E999, XXH64("abc") = 0x44BC2CF5AD770999
+    const uint8_t* check = reinterpret_cast<const uint8_t*>("123456789");
+    const uint8_t* abc = reinterpret_cast<const uint8_t*>("abc");
+    const bool kat = crc32c_bytewise(0, check, 9) == 0xE3069283 && crc32c_slice8(0, check, 9) == 0xE3069283 &&
+                     xxh64(abc, 0, 0) == 0xEF46DB3751D8E999ull && xxh64(abc, 3, 0) == 0x44BC2CF5AD770999ull;
+    std::cout << "Known-answer tests: " << (kat ? "ok" : "FAILED") << std::endl;
+
+    const Kernels simd = pick_kernels(true);
+    const Kernels scalar = pick_kernels(false);
+    std::cout << "Dispatch: CRC32C " << simd.crc_name << ", hash64 " << simd.hash_name << std::endl;
+
+    const size_t BIG = 256u << 20;   // DRAM-sized: aggregate throughput
+    const size_t SMALL = 256u << 10; // L2-sized: per-core compute throughput
+    std::vector<uint8_t> data(BIG);
+    std::mt19937_64 rng(99);
+    for (size_t i = 0; i + 8 <= BIG; i += 8) { uint64_t v = rng(); std::memcpy(&data[i], &v, 8); }
+    const uint8_t* p = data.data();
+
+    // Cross-checks: every variant must agree with the simplest one, including odd lengths and the combine path
+    bool agree = true;
+    for (size_t n : {size_t(0), size_t(1), size_t(7), size_t(31), size_t(33), size_t(511), size_t(513),
+                     size_t(3 * CRC_STRIPE - 1), size_t(3 * CRC_STRIPE + 9), size_t(100003)}) {
+        const uint32_t ref = crc32c_bytewise(0, p + 3, n);
+        agree &= crc32c_slice8(0, p + 3, n) == ref && simd.crc32c(0, p + 3, n) == ref;
+        agree &= crc32c_hw(0, p + 3, n) == ref || !__builtin_cpu_supports("sse4.2");
+        agree &= crc32c_combine(crc32c_bytewise(0, p + 3, n / 3), crc32c_bytewise(0, p + 3 + n / 3, n - n / 3),
+                                n - n / 3) == ref;
+        agree &= simd.hash64(p + 3, n, 42) == wide_hash64_scalar(p + 3, n, 42);
+    }
+    std::cout << "Scalar / SIMD / combined results agree: " << (agree ? "Yes" : "NO") << std::endl;
+
+    std::cout << "\nPer core, " << (SMALL >> 10) << " KiB buffer (cache-resident), GB/s" << std::endl;
+    const size_t per_core_bytes = SMALL * 64;
+    auto per_core = [&](const char* name, auto fn) {
+        double g = gbps(per_core_bytes, 5, [&] {
+            uint64_t acc = 0;
+            for (int r = 0; r < 64; ++r) acc = fn(p, SMALL, acc); // Chained, so calls cannot be hoisted
+            sink = acc;
+        });
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(8) << g << std::endl;
+    };
+    per_core("CRC32C bytewise table", [](const uint8_t* b, size_t n, uint64_t c) { return crc32c_bytewise(uint32_t(c), b, n); });
+    per_core("CRC32C slice-by-8", [](const uint8_t* b, size_t n, uint64_t c) { return crc32c_slice8(uint32_t(c), b, n); });
+    if (__builtin_cpu_supports("sse4.2")) {
+        per_core("CRC32C SSE4.2, 1 stream", [](const uint8_t* b, size_t n, uint64_t c) { return crc32c_hw(uint32_t(c), b, n); });
+        per_core("CRC32C SSE4.2, 3 streams", [](const uint8_t* b, size_t n, uint64_t c) { return crc32c_hw3(uint32_t(c), b, n); });
+    }
+    per_core("XXH64", [](const uint8_t* b, size_t n, uint64_t h) { return xxh64(b, n, h); });
+    per_core("wide_hash64 scalar", [](const uint8_t* b, size_t n, uint64_t h) { return wide_hash64_scalar(b, n, h); });
+    if (__builtin_cpu_supports("avx2"))
+        per_core("wide_hash64 AVX2", [](const uint8_t* b, size_t n, uint64_t h) { return wide_hash64_avx2(b, n, h); });
+
+    std::vector<int> thread_counts;
+    const int hw = std::max(1u, std::thread::hardware_concurrency());
+    for (int t = 1; t <= std::max(4, hw); t *= 2) thread_counts.push_back(t);
+
+    std::cout << "\nAggregate, " << (BIG >> 20) << " MiB buffer, GB/s (hardware threads: " << hw << ")" << std::endl;
+    std::cout << "  threads  CRC32C scalar  CRC32C " << std::setw(9) << simd.crc_name << "  tree " << std::setw(6)
+              << scalar.hash_name << "  tree " << std::setw(6) << simd.hash_name << "   same result" << std::endl;
+    const uint32_t crc_ref = crc32c_parallel(simd, p, BIG, 1);
+    const uint64_t tree_ref = tree_hash(scalar, p, BIG, 1);
+    for (int t : thread_counts) {
+        uint32_t c1 = 0, c2 = 0;
+        uint64_t h1 = 0, h2 = 0;
+        double g_crc_scalar = gbps(BIG, 3, [&] { c1 = crc32c_parallel(scalar, p, BIG, t); });
+        double g_crc_simd = gbps(BIG, 3, [&] { c2 = crc32c_parallel(simd, p, BIG, t); });
+        double g_tree_scalar = gbps(BIG, 3, [&] { h1 = tree_hash(scalar, p, BIG, t); });
+        double g_tree_simd = gbps(BIG, 3, [&] { h2 = tree_hash(simd, p, BIG, t); });
+        const bool same = c1 == crc_ref && c2 == crc_ref && h1 == tree_ref && h2 == tree_ref;
+        std::cout << "  " << std::setw(7) << t << std::setw(15) << g_crc_scalar << std::setw(17) << g_crc_simd
+                  << std::setw(13) << g_tree_scalar << std::setw(13) << g_tree_simd << std::setw(14)
+                  << (same ? "Yes" : "NO") << std::endl;
+    }
+    std::cout << "CRC32C = 0x" << std::hex << crc_ref << ", tree hash = 0x" << tree_ref << std::dec << std::endl;
+    return 0;
+}
+// cd SIMD; g++ checksum.cpp -o bin/checksum -std=c++17 -O2 -pthread; ./bin/checksum
@@ -0,0 +1,435 @@
+// Roofline Measurement Tool
+// Concept: Measure the two ceilings of this machine - peak FLOP/s (per instruction set) and memory bandwidth
+// (per cache level and DRAM) - then place real kernels on the roofline by their arithmetic intensity
+// (FLOPs per byte moved). A kernel is bounded by min(peak_flops, intensity * bandwidth); how far it sits
+// below that line tells you whether it is worth optimizing further.
+
+// Output: a text table, an ASCII log-log roofline plot and a CSV file (roofline.csv) for external plotting.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <immintrin.h> // SSE/AVX/AVX-512 intrinsics
+#include <unistd.h>    // sysconf for cache sizes
+#include <omp.h>
+
+// --- Peak FLOP/s: independent FMA chains ---
+// Each chain is a dependent sequence acc = acc * m + a. One chain is limited by FMA latency (~4 cycles),
+// so we run CHAINS of them side by side to saturate the FMA ports (2 ports x 4 cycles = 8, plus slack).
+constexpr int CHAINS = 12;
+constexpr long FMA_ITERS = 20'000'000;
+
+// Keeps the compiler from discarding results. Kernels running on several threads return their result; only the
+// serial code after the parallel region writes here.
+volatile float sink;
+
+// Horizontal sums. _mm512_reduce_add_ps (and the plain 256-bit extract/cast it uses) trips -Wuninitialized inside
+// GCC 12's avx512fintrin.h at -O3, so the 512-bit sum folds to 256 bits with the zero-masked extract (AVX-512F
+// only, unlike _mm512_extractf32x8_ps) and finishes on the 256-bit path.
+__attribute__((target("avx")))
+inline float hsum_avx(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx512f")))
+inline float hsum_avx512(__m512 v) {
+    const __m512d d = _mm512_castps_pd(v);
+    __m256 lo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, d, 0));
+    __m256 hi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, d, 1));
+    return hsum_avx(_mm256_add_ps(lo, hi));
+}
+
+__attribute__((target("fma")))
+float peak_scalar(long iters) {
+    __m128 acc[CHAINS];
+    for (int j = 0; j < CHAINS; ++j) acc[j] = _mm_set_ss(0.1f * j);
+    const __m128 m = _mm_set_ss(0.999999f), a = _mm_set_ss(1e-6f);
+    for (long i = 0; i < iters; ++i) {
+        #pragma GCC unroll 16
+        for (int j = 0; j < CHAINS; ++j) acc[j] = _mm_fmadd_ss(acc[j], m, a);
+    }
+    float s = 0;
+    for (int j = 0; j < CHAINS; ++j) s += _mm_cvtss_f32(acc[j]);
+    return s;
+}
+
+// Plain SSE has no FMA instruction, so each step is a separate multiply and add (still 2 FLOPs per lane).
+float peak_sse(long iters) {
+    __m128 acc[CHAINS];
+    for (int j = 0; j < CHAINS; ++j) acc[j] = _mm_set1_ps(0.1f * j);
+    const __m128 m = _mm_set1_ps(0.999999f), a = _mm_set1_ps(1e-6f);
+    for (long i = 0; i < iters; ++i) {
+        #pragma GCC unroll 16
+        for (int j = 0; j < CHAINS; ++j) acc[j] = _mm_add_ps(_mm_mul_ps(acc[j], m), a);
+    }
+    __m128 s = _mm_setzero_ps();
+    for (int j = 0; j < CHAINS; ++j) s = _mm_add_ps(s, acc[j]);
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+float peak_avx2(long iters) {
+    __m256 acc[CHAINS];
+    for (int j = 0; j < CHAINS; ++j) acc[j] = _mm256_set1_ps(0.1f * j);
+    const __m256 m = _mm256_set1_ps(0.999999f), a = _mm256_set1_ps(1e-6f);
+    for (long i = 0; i < iters; ++i) {
+        #pragma GCC unroll 16
+        for (int j = 0; j < CHAINS; ++j) acc[j] = _mm256_fmadd_ps(acc[j], m, a);
+    }
+    __m256 s = _mm256_setzero_ps();
+    for (int j = 0; j < CHAINS; ++j) s = _mm256_add_ps(s, acc[j]);
+    return _mm256_cvtss_f32(s);
+}
+
+__attribute__((target("avx512f")))
+float peak_avx512(long iters) {
+    __m512 acc[CHAINS];
+    for (int j = 0; j < CHAINS; ++j) acc[j] = _mm512_set1_ps(0.1f * j);
+    const __m512 m = _mm512_set1_ps(0.999999f), a = _mm512_set1_ps(1e-6f);
+    for (long i = 0; i < iters; ++i) {
+        #pragma GCC unroll 16
+        for (int j = 0; j < CHAINS; ++j) acc[j] = _mm512_fmadd_ps(acc[j], m, a);
+    }
+    __m512 s = _mm512_setzero_ps();
+    for (int j = 0; j < CHAINS; ++j) s = _mm512_add_ps(s, acc[j]);
+    return hsum_avx512(s);
+}
+
+struct PeakKernel {
+    const char* name;
+    float (*fn)(long);
+    int lanes; // float lanes per instruction
+    bool supported;
+};
+
+// Run the FMA chains on 'threads' threads; returns GFLOP/s (best of 3)
+double measure_peak(const PeakKernel& k, int threads) {
+    const long iters = FMA_ITERS / k.lanes + 1000; // Keep runtime roughly constant across widths
+    double best = 1e30;
+    std::vector<float> results(threads);
+    for (int trial = 0; trial < 3; ++trial) {
+        double t0 = omp_get_wtime();
+        #pragma omp parallel num_threads(threads)
+        results[omp_get_thread_num()] = k.fn(iters);
+        best = std::min(best, omp_get_wtime() - t0);
+    }
+    float total = 0;
+    for (float r : results) total += r;
+    sink = total;
+    double flops = 2.0 * CHAINS * k.lanes * static_cast<double>(iters) * threads;
+    return flops / best * 1e-9;
+}
+
+// --- Memory bandwidth: streaming reads over a buffer sized to one cache level ---
+
+float read_sse(const float* p, size_t n) {
+    __m128 s0 = _mm_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    for (size_t i = 0; i + 16 <= n; i += 16) {
+        s0 = _mm_add_ps(s0, _mm_load_ps(p + i));
+        s1 = _mm_add_ps(s1, _mm_load_ps(p + i + 4));
+        s2 = _mm_add_ps(s2, _mm_load_ps(p + i + 8));
+        s3 = _mm_add_ps(s3, _mm_load_ps(p + i + 12));
+    }
+    return _mm_cvtss_f32(_mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3)));
+}
+
+__attribute__((target("avx2")))
+float read_avx2(const float* p, size_t n) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    for (size_t i = 0; i + 32 <= n; i += 32) {
+        s0 = _mm256_add_ps(s0, _mm256_load_ps(p + i));
+        s1 = _mm256_add_ps(s1, _mm256_load_ps(p + i + 8));
+        s2 = _mm256_add_ps(s2, _mm256_load_ps(p + i + 16));
+        s3 = _mm256_add_ps(s3, _mm256_load_ps(p + i + 24));
+    }
+    return _mm256_cvtss_f32(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+}
+
+__attribute__((target("avx512f")))
+float read_avx512(const float* p, size_t n) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    for (size_t i = 0; i + 64 <= n; i += 64) {
+        s0 = _mm512_add_ps(s0, _mm512_load_ps(p + i));
+        s1 = _mm512_add_ps(s1, _mm512_load_ps(p + i + 16));
+        s2 = _mm512_add_ps(s2, _mm512_load_ps(p + i + 32));
+        s3 = _mm512_add_ps(s3, _mm512_load_ps(p + i + 48));
+    }
+    return hsum_avx512(_mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+}
+
+using ReadFn = float (*)(const float*, size_t);
+
+ReadFn pick_read_kernel() {
+    if (__builtin_cpu_supports("avx512f")) return read_avx512;
+    if (__builtin_cpu_supports("avx2")) return read_avx2;
+    return read_sse;
+}
+
+float* aligned_allocate(size_t count) {
+    void* ptr;
+    if (posix_memalign(&ptr, 64, count * sizeof(float)) != 0) {
+        throw std::bad_alloc();
+    }
+    return static_cast<float*>(ptr);
+}
+
+// Each thread reads its own buffer of 'bytes_per_thread' bytes, touched (and so placed) by that thread.
+// Returns aggregate GB/s (best of 3 trials).
+double measure_bandwidth(size_t bytes_per_thread, int threads, ReadFn read) {
+    const size_t n = bytes_per_thread / sizeof(float);
+    // Aim for ~1 GB of traffic per thread per trial, at least 2 passes
+    const long reps = std::max<long>(2, static_cast<long>((1UL << 30) / bytes_per_thread));
+    double best = 1e30;
+    std::vector<float> results(threads);
+
+    #pragma omp parallel num_threads(threads)
+    {
+        float* buf = aligned_allocate(n);
+        for (size_t i = 0; i < n; ++i) buf[i] = 1.0f;
+        float local = 0;
+
+        for (int trial = 0; trial < 3; ++trial) {
+            #pragma omp barrier
+            double t0 = omp_get_wtime();
+            for (long r = 0; r < reps; ++r) local += read(buf, n);
+            #pragma omp barrier
+            double t1 = omp_get_wtime();
+            #pragma omp master
+            best = std::min(best, t1 - t0);
+        }
+        results[omp_get_thread_num()] = local;
+        free(buf);
+    }
+    float total = 0;
+    for (float r : results) total += r;
+    sink = total;
+    double bytes = static_cast<double>(n) * sizeof(float) * reps * threads;
+    return bytes / best * 1e-9;
+}
+
+// --- Kernels placed on the roofline ---
+// FLOPs and bytes are counted per element as the source code expresses them (write-allocate traffic ignored).
+
+struct Kernel {
+    const char* name;
+    const char* origin;
+    double flops_per_elem;
+    double bytes_per_elem;
+    void (*fn)(const float*, const float*, float*, size_t);
+};
+
+// SIMD/vector_add.cpp: c = a + b
+void k_vector_add(const float* a, const float* b, float* c, size_t n) {
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+}
+
+// openmp/4_reduction_clause.cpp: sum += a[i]
+float reduce_sum; // Orphaned reduction target must be shared in the enclosing parallel region
+
+void k_sum_reduce(const float* a, const float*, float* c, size_t n) {
+    #pragma omp single
+    reduce_sum = 0;
+    #pragma omp for schedule(static) reduction(+:reduce_sum)
+    for (size_t i = 0; i < n; ++i) reduce_sum += a[i];
+    #pragma omp single
+    c[0] = reduce_sum;
+}
+
+// STREAM triad: c = a + s * b
+void k_triad(const float* a, const float* b, float* c, size_t n) {
+    const float s = 3.0f;
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < n; ++i) c[i] = a[i] + s * b[i];
+}
+
+// Horner polynomial of degree D: 2*D FLOPs per element, 8 bytes (read x, write y)
+template<int D>
+void k_poly(const float* a, const float*, float* c, size_t n) {
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        float x = a[i], y = 1.0f;
+        #pragma GCC unroll 128 // Straight-line body lets the i loop vectorize
+        for (int d = 0; d < D; ++d) y = y * x + 0.5f;
+        c[i] = y;
+    }
+}
+
+double measure_kernel(const Kernel& k, float* a, float* b, float* c, size_t n, int threads) {
+    double best = 1e30;
+    for (int trial = 0; trial < 3; ++trial) {
+        double t0 = omp_get_wtime();
+        #pragma omp parallel num_threads(threads)
+        k.fn(a, b, c, n);
+        best = std::min(best, omp_get_wtime() - t0);
+    }
+    return k.flops_per_elem * static_cast<double>(n) / best * 1e-9;
+}
+
+size_t cache_size(int name, size_t fallback) {
+    long v = sysconf(name);
+    return v > 0 ? static_cast<size_t>(v) : fallback;
+}
+
+// --- ASCII roofline plot (log2 intensity on x, log10 GFLOP/s on y) ---
+void plot_roofline(double peak, double bw, const std::vector<Kernel>& kernels, const std::vector<double>& gflops) {
+    const int W = 66, H = 18;
+    const double x_min = -5, x_max = 6; // intensity 1/32 .. 64 FLOP/byte
+    double y_max = std::log10(peak) + 0.2;
+    double y_min = std::log10(std::min(bw * std::exp2(x_min), *std::min_element(gflops.begin(), gflops.end()))) - 0.2;
+
+    std::vector<std::string> grid(H, std::string(W, ' '));
+    auto row_of = [&](double gf) {
+        int r = static_cast<int>(std::lround((y_max - std::log10(gf)) / (y_max - y_min) * (H - 1)));
+        return std::clamp(r, 0, H - 1);
+    };
+    auto col_of = [&](double ai) {
+        int c = static_cast<int>(std::lround((std::log2(ai) - x_min) / (x_max - x_min) * (W - 1)));
+        return std::clamp(c, 0, W - 1);
+    };
+    for (int c = 0; c < W; ++c) {
+        double ai = std::exp2(x_min + (x_max - x_min) * c / (W - 1));
+        double roof = std::min(peak, ai * bw);
+        grid[row_of(roof)][c] = roof < peak ? '/' : '-';
+    }
+    for (size_t i = 0; i < kernels.size(); ++i) {
+        double ai = kernels[i].flops_per_elem / kernels[i].bytes_per_elem;
+        grid[row_of(gflops[i])][col_of(ai)] = static_cast<char>('A' + i);
+    }
+
+    std::cout << "\nRoofline (all threads, DRAM bandwidth roof; log-log)\n";
+    for (int r = 0; r < H; ++r) {
+        double gf = std::pow(10.0, y_max - (y_max - y_min) * r / (H - 1));
+        std::cout << std::setw(9) << std::fixed << std::setprecision(gf < 10 ? 2 : 0) << gf << " |" << grid[r] << '\n';
+    }
+    std::cout << "  GFLOP/s +" << std::string(W, '-') << '\n';
+    std::cout << "           1/32       1/8        1/2         2          8         32  FLOP/byte\n";
+    for (size_t i = 0; i < kernels.size(); ++i) {
+        std::cout << "  " << static_cast<char>('A' + i) << " = " << kernels[i].name << '\n';
+    }
+}
+
+int main() {
+    const int max_threads = omp_get_max_threads();
+    std::vector<int> thread_counts = {1};
+    if (max_threads > 1) thread_counts.push_back(max_threads);
+
+    std::ofstream csv("roofline.csv");
+    csv << "kind,name,threads,arith_intensity,gflops,gbytes_per_s,roof_gflops,pct_of_roof\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    // --- Peak compute per ISA ---
+    std::vector<PeakKernel> peaks = {
+        {"scalar FMA",      peak_scalar, 1,  static_cast<bool>(__builtin_cpu_supports("fma"))},
+        {"SSE (mul+add)",   peak_sse,    4,  true},
+        {"AVX2 FMA",        peak_avx2,   8,  __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")},
+        {"AVX-512 FMA",     peak_avx512, 16, static_cast<bool>(__builtin_cpu_supports("avx512f"))},
+    };
+
+    std::cout << "--- Peak single-precision compute ---" << std::endl;
+    double best_peak_mt = 0;
+    for (const PeakKernel& k : peaks) {
+        if (!k.supported) {
+            std::cout << std::setw(16) << k.name << ": not supported on this CPU" << std::endl;
+            continue;
+        }
+        for (int t : thread_counts) {
+            double gf = measure_peak(k, t);
+            std::cout << std::setw(16) << k.name << " x" << std::setw(3) << t << " threads: "
+                      << std::setw(10) << gf << " GFLOP/s" << std::endl;
+            csv << "peak," << k.name << ',' << t << ",," << gf << ",,,\n";
+            if (t == thread_counts.back()) best_peak_mt = std::max(best_peak_mt, gf);
+        }
+    }
+
+    // --- Bandwidth per memory level ---
+    const size_t l1 = cache_size(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+    const size_t l2 = cache_size(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+    const size_t l3 = cache_size(_SC_LEVEL3_CACHE_SIZE, 8 << 20);
+    // DRAM buffer must dwarf the LLC, but stay within a sane memory footprint
+    const size_t dram = std::clamp<size_t>(4 * l3, 64UL << 20, 512UL << 20);
+
+    struct Level { const char* name; size_t bytes; bool shared; };
+    std::vector<Level> levels = {
+        {"L1", l1 / 2, false},
+        {"L2", l2 / 2, false},
+        {"L3", l3 / 2, true},
+        {"DRAM", dram, true},
+    };
+    if (dram < 4 * l3) {
+        std::cout << "\nNote: L3 reported as " << (l3 >> 20) << " MiB; DRAM buffer capped at "
+                  << (dram >> 20) << " MiB, so the DRAM figure may include cache hits." << std::endl;
+    }
+
+    ReadFn read = pick_read_kernel();
+    std::cout << "\n--- Read bandwidth per level ---" << std::endl;
+    double dram_bw_mt = 0;
+    for (const Level& lv : levels) {
+        for (int t : thread_counts) {
+            // Private levels: each thread gets a full-size buffer. Shared levels: the footprint is split.
+            size_t per_thread = lv.shared ? lv.bytes / t : lv.bytes;
+            per_thread = std::max<size_t>(per_thread & ~size_t(255), 256);
+            double gbs = measure_bandwidth(per_thread, t, read);
+            std::cout << std::setw(5) << lv.name << " (" << std::setw(8) << (per_thread >> 10) << " KiB/thread) x"
+                      << std::setw(3) << t << " threads: " << std::setw(10) << gbs << " GB/s" << std::endl;
+            csv << "bandwidth," << lv.name << ',' << t << ",,," << gbs << ",,\n";
+            if (std::string(lv.name) == "DRAM" && t == thread_counts.back()) dram_bw_mt = gbs;
+        }
+    }
+
+    // --- Kernels on the roofline (DRAM-sized arrays, all threads) ---
+    std::vector<Kernel> kernels = {
+        {"vector_add",  "SIMD/vector_add.cpp",           1,   12, k_vector_add},
+        {"sum_reduce",  "openmp/4_reduction_clause.cpp", 1,   4,  k_sum_reduce},
+        {"triad",       "STREAM",                        2,   12, k_triad},
+        {"poly16",      "Horner degree 16",              32,  8,  k_poly<16>},
+        {"poly128",     "Horner degree 128",             256, 8,  k_poly<128>},
+    };
+
+    const size_t n = dram / sizeof(float) / 3;
+    float* a = aligned_allocate(n);
+    float* b = aligned_allocate(n);
+    float* c = aligned_allocate(n);
+    const int t = thread_counts.back();
+    #pragma omp parallel for num_threads(t) schedule(static) // First touch with the same schedule as the kernels
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = 0.5f + 1e-7f * static_cast<float>(i % 1000);
+        b[i] = 1.0f;
+        c[i] = 0.0f;
+    }
+
+    std::cout << "\n--- Kernels (" << t << " threads, " << (n * sizeof(float) >> 20) << " MiB per array) ---" << std::endl;
+    std::cout << std::setw(12) << "kernel" << std::setw(12) << "FLOP/byte" << std::setw(12) << "GFLOP/s"
+              << std::setw(12) << "roof" << std::setw(10) << "% roof" << "  bound" << std::endl;
+    std::vector<double> attained;
+    for (const Kernel& k : kernels) {
+        double ai = k.flops_per_elem / k.bytes_per_elem;
+        double gf = measure_kernel(k, a, b, c, n, t);
+        double roof = std::min(best_peak_mt, ai * dram_bw_mt);
+        attained.push_back(gf);
+        std::cout << std::setw(12) << k.name << std::setw(12) << std::setprecision(3) << ai
+                  << std::setw(12) << std::setprecision(2) << gf << std::setw(12) << roof
+                  << std::setw(9) << 100.0 * gf / roof << "%  "
+                  << (ai * dram_bw_mt < best_peak_mt ? "memory" : "compute") << std::endl;
+        csv << "kernel," << k.name << ',' << t << ',' << ai << ',' << gf << ",," << roof << ',' << 100.0 * gf / roof << '\n';
+    }
+
+    plot_roofline(best_peak_mt, dram_bw_mt, kernels, attained);
+    std::cout << "\nCSV written to roofline.csv" << std::endl;
+
+    free(a);
+    free(b);
+    free(c);
+    return 0;
+}
+
+// cd SIMD; g++ roofline.cpp -o bin/roofline -std=c++17 -O3 -fopenmp; ./bin/roofline
+// OMP_NUM_THREADS controls the multi-threaded rows.
@@ -0,0 +1,399 @@
+// Contention-Free, Reproducible Parallel Random Number Generation (counter-based Philox + SIMD xoshiro lanes)
+
+// Concept: Our benchmarks fill data[i] / a[i] serially from one std::mt19937. Parallelizing that naively means
+// either sharing the engine under a lock (every draw serializes on one cache line) or giving each thread its
+// own engine seeded with the thread id - fast, but the data now depends on OMP_NUM_THREADS.
+// Fix: make the random stream a function of the ELEMENT (or a fixed-size chunk), never of the thread.
+//   1. Counter-based generators (Philox4x32-10, Threefry2x32-20): output = bijection(key=seed, counter=index).
+//      No state at all, so any thread can compute element i directly; the parallel fill is bit-identical to
+//      the sequential stream. Philox's rounds are 32x32->64 multiplies, Threefry's are add/rotate/xor, and both
+//      vectorize across counters with #pragma omp simd.
+//   2. State-based xoshiro256** in LANES independent SIMD lanes. Each fixed-size CHUNK of the output gets its
+//      own lanes, seeded by splitmix64(seed, chunk, lane); threads take whole chunks, so the result depends
+//      only on (seed, CHUNK), not on which thread ran which chunk.
+// Distributions: uniform floats from the top 24 bits; normals by Box-Muller on pairs of uniforms.
+// Use Case: Parallel synthetic-data generation, Monte Carlo, randomized tests that must replay exactly.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <mutex>
+#include <cmath>
+#include <cstdint>
+#include <cstring>   // std::memcpy for hashing float bits
+#include <algorithm> // std::min
+#include <omp.h>
+
+constexpr long CHUNK = 1 << 16; // Elements per independent stream chunk: fixed, so output never depends on threads
+
+// --- Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3") ---
+constexpr uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+constexpr int PHILOX_LANES = 16; // Counters processed together: 16 x uint32 = one AVX-512 / two AVX2 registers
+
+// One counter, scalar: used for the known-answer test and as the readable reference
+void philox4x32(const uint32_t ctr[4], uint32_t k0, uint32_t k1, uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    for (int r = 0; r < 10; ++r) {
+        uint64_t p0 = uint64_t(PHILOX_M0) * c0;
+        uint64_t p1 = uint64_t(PHILOX_M1) * c2;
+        uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+        c0 = n0; c1 = uint32_t(p1); c2 = n2; c3 = uint32_t(p0);
+        k0 += PHILOX_W0; k1 += PHILOX_W1;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// PHILOX_LANES consecutive counters starting at `first`, 4 * PHILOX_LANES outputs in planar order
+// (out[j * LANES + l] is word j of counter first + l); this is the definition of the stream used everywhere below.
+void philox_block(uint64_t first, uint32_t k0, uint32_t k1, uint32_t* out) {
+    uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+    #pragma omp simd
+    for (int l = 0; l < PHILOX_LANES; ++l) {
+        c0[l] = uint32_t(first + l);
+        c1[l] = uint32_t((first + l) >> 32);
+        c2[l] = 0;
+        c3[l] = 0;
+    }
+    for (int r = 0; r < 10; ++r) {
+        #pragma omp simd
+        for (int l = 0; l < PHILOX_LANES; ++l) {
+            uint64_t p0 = uint64_t(PHILOX_M0) * c0[l];
+            uint64_t p1 = uint64_t(PHILOX_M1) * c2[l];
+            uint32_t n0 = uint32_t(p1 >> 32) ^ c1[l] ^ k0;
+            uint32_t n2 = uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+            c0[l] = n0; c1[l] = uint32_t(p1); c2[l] = n2; c3[l] = uint32_t(p0);
+        }
+        k0 += PHILOX_W0; k1 += PHILOX_W1;
+    }
+    std::memcpy(out, c0, sizeof(c0));
+    std::memcpy(out + PHILOX_LANES, c1, sizeof(c1));
+    std::memcpy(out + 2 * PHILOX_LANES, c2, sizeof(c2));
+    std::memcpy(out + 3 * PHILOX_LANES, c3, sizeof(c3));
+}
+
+// --- Threefry2x32-20 (same paper): add/rotate/xor only, key injection every 4 rounds ---
+constexpr int THREEFRY_ROT[8] = {13, 15, 26, 6, 17, 29, 16, 24};
+constexpr int THREEFRY_LANES = 16;
+
+inline uint32_t rotl32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+void threefry2x32(const uint32_t ctr[2], uint32_t k0, uint32_t k1, uint32_t out[2]) {
+    const uint32_t ks[3] = {k0, k1, 0x1BD11BDA ^ k0 ^ k1};
+    uint32_t x0 = ctr[0] + ks[0], x1 = ctr[1] + ks[1];
+    for (int r = 0; r < 20; ++r) {
+        x0 += x1; x1 = rotl32(x1, THREEFRY_ROT[r % 8]); x1 ^= x0;
+        if (r % 4 == 3) {
+            int s = (r + 1) / 4;
+            x0 += ks[s % 3];
+            x1 += ks[(s + 1) % 3] + s;
+        }
+    }
+    out[0] = x0; out[1] = x1;
+}
+
+// THREEFRY_LANES consecutive counters, 2 * THREEFRY_LANES outputs in planar order (as philox_block)
+void threefry_block(uint64_t first, uint32_t k0, uint32_t k1, uint32_t* out) {
+    const uint32_t ks[3] = {k0, k1, 0x1BD11BDA ^ k0 ^ k1};
+    uint32_t x0[THREEFRY_LANES], x1[THREEFRY_LANES];
+    #pragma omp simd
+    for (int l = 0; l < THREEFRY_LANES; ++l) {
+        x0[l] = uint32_t(first + l) + ks[0];
+        x1[l] = uint32_t((first + l) >> 32) + ks[1];
+    }
+    for (int r = 0; r < 20; ++r) {
+        const int rot = THREEFRY_ROT[r % 8];
+        #pragma omp simd
+        for (int l = 0; l < THREEFRY_LANES; ++l) {
+            x0[l] += x1[l];
+            x1[l] = rotl32(x1[l], rot);
+            x1[l] ^= x0[l];
+        }
+        if (r % 4 == 3) {
+            const int s = (r + 1) / 4;
+            const uint32_t a = ks[s % 3], b = ks[(s + 1) % 3] + s;
+            #pragma omp simd
+            for (int l = 0; l < THREEFRY_LANES; ++l) { x0[l] += a; x1[l] += b; }
+        }
+    }
+    std::memcpy(out, x0, sizeof(x0));
+    std::memcpy(out + THREEFRY_LANES, x1, sizeof(x1));
+}
+
+// --- xoshiro256** in SIMD lanes (Blackman & Vigna) ---
+constexpr int XOSHIRO_LANES = 8; // 8 x uint64 = one AVX-512 / two AVX2 registers per state word
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+struct XoshiroLanes {
+    uint64_t s0[XOSHIRO_LANES], s1[XOSHIRO_LANES], s2[XOSHIRO_LANES], s3[XOSHIRO_LANES];
+
+    // Independent lanes for one stream id (a chunk index): splitmix64 decorrelates nearby ids, and with a
+    // 2^256 period per lane the chance of two lanes' windows overlapping is negligible.
+    XoshiroLanes(uint64_t seed, uint64_t stream) {
+        uint64_t sm = seed ^ (stream * 0xD1B54A32D192ED03ull);
+        for (int l = 0; l < XOSHIRO_LANES; ++l) {
+            s0[l] = splitmix64(sm); s1[l] = splitmix64(sm);
+            s2[l] = splitmix64(sm); s3[l] = splitmix64(sm);
+        }
+    }
+
+    // XOSHIRO_LANES outputs; x * 5 and x * 9 compile to shift+add, so every step is plain SIMD integer ops
+    void next(uint64_t* out) {
+        #pragma omp simd
+        for (int l = 0; l < XOSHIRO_LANES; ++l) {
+            out[l] = rotl64(s1[l] * 5, 7) * 9;
+            const uint64_t t = s1[l] << 17;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = rotl64(s3[l], 45);
+        }
+    }
+};
+
+// --- Bits to distributions ---
+inline float to_unit_float(uint32_t x) { return float(x >> 8) * (1.0f / 16777216.0f); } // [0, 1), 24 bits
+
+// Box-Muller on (u1, u2) -> two independent N(0, 1); u1 is shifted to (0, 1] so log never sees 0
+inline void box_muller(uint32_t a, uint32_t b, float& z0, float& z1) {
+    const float u1 = float((a >> 8) + 1) * (1.0f / 16777216.0f);
+    const float u2 = to_unit_float(b);
+    const float r = std::sqrt(-2.0f * std::log(u1));
+    const float theta = 6.28318530718f * u2;
+    z0 = r * std::cos(theta);
+    z1 = r * std::sin(theta);
+}
+
+// --- Parallel fill kernels. All take (seed) and produce the same bits for any thread count. ---
+// Chunk c covers elements [c * CHUNK, (c + 1) * CHUNK); schedule(static) hands out whole chunks.
+
+void fill_uniform_philox(std::vector<float>& out, uint64_t seed) {
+    const long n = out.size(), chunks = (n + CHUNK - 1) / CHUNK;
+    const uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+    constexpr int PER_BLOCK = 4 * PHILOX_LANES;
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c) {
+        uint32_t bits[PER_BLOCK];
+        const long end = std::min(n, (c + 1) * CHUNK);
+        for (long i = c * CHUNK; i < end; i += PER_BLOCK) { // CHUNK % PER_BLOCK == 0: blocks never straddle chunks
+            philox_block(uint64_t(i) / 4, k0, k1, bits);      // Counter = element index / 4: one global stream
+            const int m = int(std::min<long>(PER_BLOCK, end - i));
+            #pragma omp simd
+            for (int j = 0; j < m; ++j) out[i + j] = to_unit_float(bits[j]);
+        }
+    }
+}
+
+void fill_uniform_threefry(std::vector<float>& out, uint64_t seed) {
+    const long n = out.size(), chunks = (n + CHUNK - 1) / CHUNK;
+    const uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+    constexpr int PER_BLOCK = 2 * THREEFRY_LANES;
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c) {
+        uint32_t bits[PER_BLOCK];
+        const long end = std::min(n, (c + 1) * CHUNK);
+        for (long i = c * CHUNK; i < end; i += PER_BLOCK) {
+            threefry_block(uint64_t(i) / 2, k0, k1, bits);
+            const int m = int(std::min<long>(PER_BLOCK, end - i));
+            #pragma omp simd
+            for (int j = 0; j < m; ++j) out[i + j] = to_unit_float(bits[j]);
+        }
+    }
+}
+
+void fill_uniform_xoshiro(std::vector<float>& out, uint64_t seed) {
+    const long n = out.size(), chunks = (n + CHUNK - 1) / CHUNK;
+    constexpr int PER_BLOCK = 2 * XOSHIRO_LANES; // Both 32-bit halves of each 64-bit output
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c) {
+        XoshiroLanes gen(seed, uint64_t(c)); // Stream belongs to the chunk, not to the thread
+        uint64_t bits[XOSHIRO_LANES];
+        const long end = std::min(n, (c + 1) * CHUNK);
+        for (long i = c * CHUNK; i < end; i += PER_BLOCK) {
+            gen.next(bits);
+            const int m = int(std::min<long>(PER_BLOCK, end - i));
+            #pragma omp simd
+            for (int j = 0; j < m; ++j) {
+                const uint64_t w = bits[j % XOSHIRO_LANES];
+                out[i + j] = to_unit_float(uint32_t(j < XOSHIRO_LANES ? w >> 32 : w));
+            }
+        }
+    }
+}
+
+// Normals from Philox: words j and j + 2 * LANES of a block form one Box-Muller pair
+void fill_normal_philox(std::vector<float>& out, uint64_t seed) {
+    const long n = out.size(), chunks = (n + CHUNK - 1) / CHUNK;
+    const uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+    constexpr int PER_BLOCK = 4 * PHILOX_LANES, HALF = PER_BLOCK / 2;
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c) {
+        uint32_t bits[PER_BLOCK];
+        float z[PER_BLOCK];
+        const long end = std::min(n, (c + 1) * CHUNK);
+        for (long i = c * CHUNK; i < end; i += PER_BLOCK) {
+            philox_block(uint64_t(i) / 4, k0, k1, bits);
+            #pragma omp simd
+            for (int j = 0; j < HALF; ++j) box_muller(bits[j], bits[j + HALF], z[j], z[j + HALF]);
+            const int m = int(std::min<long>(PER_BLOCK, end - i));
+            for (int j = 0; j < m; ++j) out[i + j] = z[j];
+        }
+    }
+}
+
+// --- Baselines ---
+
+// What the existing benchmarks do: one engine, one thread
+void fill_uniform_mt_serial(std::vector<float>& out, uint64_t seed) {
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (float& x : out) x = dist(rng);
+}
+
+void fill_normal_mt_serial(std::vector<float>& out, uint64_t seed) {
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (float& x : out) x = dist(rng);
+}
+
+// Anti-pattern: a shared engine behind a lock. Correct, but every draw is a serialized lock handoff.
+void fill_uniform_mt_locked(std::vector<float>& out, uint64_t seed) {
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::mutex m;
+    const long n = out.size();
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; ++i) {
+        std::lock_guard<std::mutex> lock(m);
+        out[i] = dist(rng);
+    }
+}
+
+// Fast but not reproducible: stream depends on the thread id and on how many threads split the range
+void fill_uniform_mt_per_thread(std::vector<float>& out, uint64_t seed) {
+    const long n = out.size();
+    #pragma omp parallel
+    {
+        std::mt19937 rng(uint32_t(seed) + omp_get_thread_num());
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        #pragma omp for schedule(static)
+        for (long i = 0; i < n; ++i) out[i] = dist(rng);
+    }
+}
+
+// --- Harness ---
+
+uint64_t hash_floats(const std::vector<float>& v) { // FNV-1a over the bit patterns
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (float x : v) {
+        uint32_t b;
+        std::memcpy(&b, &x, sizeof(b));
+        h = (h ^ b) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+template<typename Fill>
+double best_seconds(Fill fill, std::vector<float>& out, uint64_t seed, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        double t0 = omp_get_wtime();
+        fill(out, seed);
+        best = std::min(best, omp_get_wtime() - t0);
+    }
+    return best;
+}
+
+void moments(const std::vector<float>& v, double& mean, double& var) {
+    double s = 0.0, s2 = 0.0;
+    for (float x : v) { s += x; s2 += double(x) * x; }
+    mean = s / v.size();
+    var = s2 / v.size() - mean * mean;
+}
+
+int main() {
+    std::cout << "--- Parallel RNG: Philox / Threefry counters, xoshiro256** SIMD lanes ---" << std::endl;
+
+    // Known-answer tests from the Random123 distribution (counter = key = 0)
+    const uint32_t zero4[4] = {0, 0, 0, 0};
+    uint32_t ph[4], tf[2];
+    philox4x32(zero4, 0, 0, ph);
+    threefry2x32(zero4, 0, 0, tf);
+    const bool philox_kat = ph[0] == 0x6627E8D5 && ph[1] == 0xE169C58D && ph[2] == 0xBC57AC4C && ph[3] == 0x9B00DBD8;
+    const bool threefry_kat = tf[0] == 0x6B200159 && tf[1] == 0x99BA4EFE;
+    uint32_t block[4 * PHILOX_LANES];
+    philox_block(0, 0, 0, block); // Lane 0 of the SIMD block must equal the scalar reference
+    const bool philox_simd = block[0] == ph[0] && block[PHILOX_LANES] == ph[1] &&
+                             block[2 * PHILOX_LANES] == ph[2] && block[3 * PHILOX_LANES] == ph[3];
+    std::cout << "Known-answer tests: Philox4x32-10 " << (philox_kat ? "ok" : "FAILED") << ", Threefry2x32-20 "
+              << (threefry_kat ? "ok" : "FAILED") << ", Philox SIMD lane " << (philox_simd ? "ok" : "FAILED") << std::endl;
+
+    const long N = 1L << 24; // 16M floats = 64 MiB per fill
+    const uint64_t SEED = 0x5EEDF00DCAFEull;
+    const int max_threads = omp_get_max_threads();
+    std::vector<float> out(N);
+
+    struct Kernel { const char* name; void (*fill)(std::vector<float>&, uint64_t); bool parallel; };
+    const Kernel kernels[] = {
+        {"mt19937 uniform (serial)", fill_uniform_mt_serial, false},
+        {"mt19937 uniform (per-thread)", fill_uniform_mt_per_thread, true},
+        {"Philox4x32-10 uniform", fill_uniform_philox, true},
+        {"Threefry2x32-20 uniform", fill_uniform_threefry, true},
+        {"xoshiro256** x8 uniform", fill_uniform_xoshiro, true},
+        {"mt19937 normal (serial)", fill_normal_mt_serial, false},
+        {"Philox4x32-10 normal", fill_normal_philox, true},
+    };
+
+    std::vector<int> thread_counts;
+    for (int t = 1; t <= std::max(4, max_threads); t *= 2) thread_counts.push_back(t);
+
+    std::cout << "\nN = " << N << " floats, CHUNK = " << CHUNK << ", max threads = " << max_threads << std::endl;
+    std::cout << std::left << std::setw(30) << "Kernel" << std::right << std::setw(10) << "threads"
+              << std::setw(10) << "GB/s" << std::setw(20) << "output hash" << std::setw(10) << "mean" << std::setw(10) << "var" << std::endl;
+    for (const Kernel& k : kernels) {
+        uint64_t first_hash = 0;
+        bool reproducible = true;
+        for (int t : thread_counts) {
+            if (!k.parallel && t > 1) break;
+            omp_set_num_threads(t);
+            double s = best_seconds(k.fill, out, SEED, 3);
+            uint64_t h = hash_floats(out);
+            if (t == 1) first_hash = h;
+            reproducible &= h == first_hash;
+            double mean, var;
+            moments(out, mean, var);
+            std::cout << std::left << std::setw(30) << k.name << std::right << std::setw(10) << t
+                      << std::setw(10) << std::fixed << std::setprecision(2) << N * sizeof(float) / s / 1e9
+                      << "    " << std::hex << std::setw(16) << std::setfill('0') << h << std::dec << std::setfill(' ')
+                      << std::setw(10) << std::setprecision(4) << mean << std::setw(10) << var << std::endl;
+        }
+        if (k.parallel) std::cout << "    -> identical across thread counts: " << (reproducible ? "Yes" : "NO") << std::endl;
+    }
+    std::cout << "(uniform: mean 0.5, var 0.0833; normal: mean 0, var 1)" << std::endl;
+
+    // The lock anti-pattern on a smaller array: it only gets slower as threads are added
+    std::vector<float> small(N / 16);
+    std::cout << "\nShared mt19937 behind a mutex (" << small.size() << " floats)" << std::endl;
+    for (int t : thread_counts) {
+        omp_set_num_threads(t);
+        double s = best_seconds(fill_uniform_mt_locked, small, SEED, 1);
+        std::cout << "    threads " << std::setw(2) << t << ": " << std::setprecision(3)
+                  << small.size() * sizeof(float) / s / 1e9 << " GB/s" << std::endl;
+    }
+    return 0;
+}
+
+// Compile (GCC/Clang): g++ 10_parallel_rng.cpp -o bin/parallel_rng -fopenmp -O3 -march=native -std=c++17
+// -march=native lets the #pragma omp simd loops use AVX2/AVX-512 (vpmuludq for Philox, 64-bit lanes for xoshiro).
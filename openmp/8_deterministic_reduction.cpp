@@ -0,0 +1,260 @@
+// Deterministic Floating-Point Reduction (fixed blocks + SIMD multi-accumulators + fixed-shape tree combine)
+
+// Concept: Floating-point addition is not associative, so reduction(+:sum) over floats (see 4_reduction_clause.cpp,
+// which sums ints) gives a result that depends on how iterations were split across threads: change
+// OMP_NUM_THREADS and the last bits of the sum change.
+// Fix: make the shape of the computation independent of the thread count.
+//   1. Split the input into fixed-size BLOCKS (not one chunk per thread). Threads pick up whole blocks, but
+//      every block is summed the same way no matter which thread runs it.
+//   2. Inside a block, sum with LANES independent accumulators (acc[j] += x[i + j]); the compiler vectorizes this
+//      without -ffast-math because each lane is its own dependency chain, and it hides FP add latency.
+//   3. Combine the lanes, then the per-block partials, with a fixed pairwise tree (stride 1, 2, 4, ...).
+// The result depends only on N and BLOCK, so it is bitwise identical for 1, 2, 3, ... threads.
+// Optional compensated mode: Kahan per lane inside each block and error-free TwoSum in the tree, for near
+// double-precision accuracy from a float accumulator.
+// Use Case: Reproducible results across machines/thread counts (debugging, regression tests, scientific codes).
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstring>   // std::memcpy for printing float bits
+#include <algorithm> // std::min
+#include <omp.h>
+
+constexpr long BLOCK = 4096; // Elements per block: fixed, so the summation shape never depends on the thread count
+constexpr int LANES = 32;    // Independent accumulators per block (4 AVX2 / 2 AVX-512 registers of floats)
+
+// Sum of a (sum, compensation) pair carried through the compensated tree
+struct CompSum {
+    float sum;
+    float comp;
+};
+
+// Error-free transformation: a + b == s + err exactly (Knuth's TwoSum, no branch on magnitudes)
+inline CompSum two_sum(float a, float b) {
+    float s = a + b;
+    float bv = s - a;
+    float av = s - bv;
+    return {s, (a - av) + (b - bv)};
+}
+
+// Fixed pairwise tree over the LANES accumulators of one block (serial: already inside a parallel loop)
+float combine_lanes(float* acc) {
+    for (int stride = 1; stride < LANES; stride *= 2) {
+        for (int j = 0; j < LANES; j += 2 * stride) acc[j] += acc[j + stride];
+    }
+    return acc[0];
+}
+
+CompSum combine_lanes(CompSum* acc) {
+    for (int stride = 1; stride < LANES; stride *= 2) {
+        for (int j = 0; j < LANES; j += 2 * stride) {
+            CompSum s = two_sum(acc[j].sum, acc[j + stride].sum);
+            acc[j] = {s.sum, s.comp + acc[j].comp + acc[j + stride].comp};
+        }
+    }
+    return acc[0];
+}
+
+// Fixed-shape pairwise tree over the block partials: v[0] ends up holding the sum. Shape depends only on n.
+float tree_combine(float* v, long n) {
+    for (long stride = 1; stride < n; stride *= 2) {
+        #pragma omp parallel for schedule(static) if(n / (2 * stride) > 4096)
+        for (long i = 0; i < n - stride; i += 2 * stride) {
+            v[i] += v[i + stride];
+        }
+    }
+    return n > 0 ? v[0] : 0.0f;
+}
+
+CompSum tree_combine(CompSum* v, long n) {
+    for (long stride = 1; stride < n; stride *= 2) {
+        #pragma omp parallel for schedule(static) if(n / (2 * stride) > 4096)
+        for (long i = 0; i < n - stride; i += 2 * stride) {
+            CompSum s = two_sum(v[i].sum, v[i + stride].sum);
+            v[i] = {s.sum, s.comp + v[i].comp + v[i + stride].comp};
+        }
+    }
+    return n > 0 ? v[0] : CompSum{0.0f, 0.0f};
+}
+
+// --- Block kernels (one block, always the same operation order) ---
+
+float block_sum(const float* x, long n) {
+    float acc[LANES] = {};
+    long i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (int j = 0; j < LANES; ++j) acc[j] += x[i + j]; // Vectorized: LANES independent chains
+    }
+    for (int j = 0; i < n; ++i, ++j) acc[j] += x[i]; // Tail goes to lanes 0.. in order
+    return combine_lanes(acc);
+}
+
+CompSum block_sum_kahan(const float* x, long n) {
+    float sum[LANES] = {}, comp[LANES] = {};
+    long i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (int j = 0; j < LANES; ++j) {
+            float y = x[i + j] - comp[j];
+            float t = sum[j] + y;
+            comp[j] = (t - sum[j]) - y; // What was lost when adding y; subtracted from the next term
+            sum[j] = t;
+        }
+    }
+    for (int j = 0; i < n; ++i, ++j) {
+        float y = x[i] - comp[j];
+        float t = sum[j] + y;
+        comp[j] = (t - sum[j]) - y;
+        sum[j] = t;
+    }
+    CompSum lanes[LANES];
+    for (int j = 0; j < LANES; ++j) lanes[j] = {sum[j], -comp[j]};
+    return combine_lanes(lanes);
+}
+
+// --- Whole-array reductions ---
+
+// Baseline: what reduction(+:sum) gives you. Fast, but the bits depend on the thread count.
+float naive_sum(const float* x, long n) {
+    float sum = 0.0f;
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long i = 0; i < n; ++i) {
+        sum += x[i];
+    }
+    return sum;
+}
+
+// SIMD local sums without the fixed shape: faster than naive, still thread-count dependent
+float simd_sum(const float* x, long n) {
+    float sum = 0.0f;
+    #pragma omp parallel for simd schedule(static) reduction(+:sum)
+    for (long i = 0; i < n; ++i) {
+        sum += x[i];
+    }
+    return sum;
+}
+
+// Deterministic: per-block multi-accumulator sums, then a fixed tree over the blocks
+float deterministic_sum(const float* x, long n, std::vector<float>& partials) {
+    long blocks = (n + BLOCK - 1) / BLOCK;
+    partials.resize(blocks);
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < blocks; ++b) {
+        long begin = b * BLOCK;
+        partials[b] = block_sum(x + begin, std::min(BLOCK, n - begin));
+    }
+    return tree_combine(partials.data(), blocks);
+}
+
+// Deterministic and compensated: Kahan lanes per block, TwoSum tree over the blocks
+float deterministic_kahan_sum(const float* x, long n, std::vector<CompSum>& partials) {
+    long blocks = (n + BLOCK - 1) / BLOCK;
+    partials.resize(blocks);
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < blocks; ++b) {
+        long begin = b * BLOCK;
+        partials[b] = block_sum_kahan(x + begin, std::min(BLOCK, n - begin));
+    }
+    CompSum total = tree_combine(partials.data(), blocks);
+    return total.sum + total.comp;
+}
+
+uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// Best-of-N timing of a kernel, in milliseconds
+template<typename F>
+double time_ms(F kernel, int reps = 5) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        double t0 = omp_get_wtime();
+        kernel();
+        best = std::min(best, omp_get_wtime() - t0);
+    }
+    return best * 1e3;
+}
+
+int main() {
+    std::cout << "--- Deterministic Reduction Example ---" << std::endl;
+    const long SIZE = 16 * 1024 * 1024 + 123; // Odd size: exercises the partial last block and the lane tail
+
+    // Mixed magnitudes and signs: the worst case for order-dependent rounding
+    std::vector<float> data(SIZE);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(-8, 8);
+    for (long i = 0; i < SIZE; ++i) data[i] = std::ldexp(mantissa(rng), exponent(rng)) + 0.01f;
+
+    // Reference in long double with Kahan: accurate well beyond float precision
+    long double ref = 0.0L, ref_comp = 0.0L;
+    for (long i = 0; i < SIZE; ++i) {
+        long double y = data[i] - ref_comp;
+        long double t = ref + y;
+        ref_comp = (t - ref) - y;
+        ref = t;
+    }
+
+    std::vector<float> partials;
+    std::vector<CompSum> comp_partials;
+    const int max_threads = std::max(omp_get_max_threads(), 8); // Oversubscribe on small hosts: bits are what matter
+
+    // --- Reproducibility: the same sum under different thread counts ---
+    std::cout << "\nThreads   naive bits   simd bits    determ bits  kahan bits" << std::endl;
+    bool naive_stable = true, simd_stable = true, det_stable = true, kahan_stable = true;
+    uint32_t naive0 = 0, simd0 = 0, det0 = 0, kahan0 = 0;
+    for (int t = 1; t <= max_threads; ++t) {
+        omp_set_num_threads(t);
+        uint32_t nb = float_bits(naive_sum(data.data(), SIZE));
+        uint32_t sb = float_bits(simd_sum(data.data(), SIZE));
+        uint32_t db = float_bits(deterministic_sum(data.data(), SIZE, partials));
+        uint32_t kb = float_bits(deterministic_kahan_sum(data.data(), SIZE, comp_partials));
+        if (t == 1) { naive0 = nb; simd0 = sb; det0 = db; kahan0 = kb; }
+        naive_stable &= nb == naive0;
+        simd_stable &= sb == simd0;
+        det_stable &= db == det0;
+        kahan_stable &= kb == kahan0;
+        std::cout << std::setw(7) << t << std::hex << std::setfill('0')
+                  << "   0x" << std::setw(8) << nb << "   0x" << std::setw(8) << sb
+                  << "   0x" << std::setw(8) << db << "   0x" << std::setw(8) << kb
+                  << std::dec << std::setfill(' ') << std::endl;
+    }
+    std::cout << "Bitwise identical across thread counts: naive " << (naive_stable ? "Yes" : "No")
+              << ", simd " << (simd_stable ? "Yes" : "No")
+              << ", deterministic " << (det_stable ? "Yes" : "No")
+              << ", kahan " << (kahan_stable ? "Yes" : "No") << std::endl;
+
+    // --- Speed/accuracy tradeoff at the default thread count ---
+    omp_set_num_threads(omp_get_num_procs());
+    float naive = 0, simd = 0, det = 0, kahan = 0;
+    double t_naive = time_ms([&] { naive = naive_sum(data.data(), SIZE); });
+    double t_simd = time_ms([&] { simd = simd_sum(data.data(), SIZE); });
+    double t_det = time_ms([&] { det = deterministic_sum(data.data(), SIZE, partials); });
+    double t_kahan = time_ms([&] { kahan = deterministic_kahan_sum(data.data(), SIZE, comp_partials); });
+
+    auto rel_err = [&](float v) { return static_cast<double>(std::fabs((v - ref) / ref)); };
+    double gbytes = SIZE * sizeof(float) / 1e9;
+    std::cout << "\nThreads: " << omp_get_num_procs() << ", elements: " << SIZE
+              << ", reference: " << std::setprecision(12) << static_cast<double>(ref) << std::endl;
+    std::cout << std::setprecision(4);
+    std::cout << "Mode                 time (ms)   GB/s      rel. error    deterministic" << std::endl;
+    auto row = [&](const char* name, double ms, float v, bool stable) {
+        std::cout << std::left << std::setw(21) << name << std::right << std::setw(9) << ms
+                  << std::setw(9) << gbytes / (ms * 1e-3) << "    " << std::setw(10) << rel_err(v)
+                  << "    " << (stable ? "Yes" : "No") << std::endl;
+    };
+    row("naive reduction", t_naive, naive, naive_stable);
+    row("omp simd reduction", t_simd, simd, simd_stable);
+    row("block + tree", t_det, det, det_stable);
+    row("block + tree, Kahan", t_kahan, kahan, kahan_stable);
+
+    return 0;
+}
+
+// Compile (GCC/Clang): g++ 8_deterministic_reduction.cpp -o bin/deterministic_reduction -fopenmp -O3 -march=native -std=c++17
+// Do NOT add -ffast-math: it lets the compiler reassociate the sums and deletes the Kahan compensation.
@@ -0,0 +1,428 @@
+// Parallel Hash Join and Group-By (radix partitioning + thread-local pre-aggregation)
+
+// Concept: A hash join / group-by over tens of millions of rows is dominated by cache misses: every probe into a
+// table bigger than the caches is a DRAM access. Two classic fixes, both parallelized with OpenMP:
+//   Radix-partitioned join: split both inputs by the top bits of the key hash into P partitions so that one
+//     partition's hash table fits in L2 (P is derived from the L2 size), then join partition p of R with
+//     partition p of S - independent tasks, every probe hits L2. Partitioning itself is a two-pass parallel
+//     scatter (per-thread histograms -> prefix sums -> each thread writes its own disjoint output ranges).
+//   SIMD probe: the table stores keys in groups of 8 (one AVX2 register). A probe compares the key against all 8
+//     slots with one instruction and also learns whether the group has an empty slot (= end of the chain).
+//   Group-by with thread-local pre-aggregation: each thread aggregates its rows in a private L2-sized table (no
+//     sharing, no atomics). When it fills up, its entries are spilled to per-partition buffers; each partition is
+//     then merged into a final table by one thread. Few groups: almost all work stays thread-local. Many groups:
+//     it degrades gracefully into a partitioned aggregation.
+// Baseline: single-threaded std::unordered_map.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <immintrin.h>
+#include <unistd.h> // sysconf for the L2 size
+#include <omp.h>
+
+struct Tuple {
+    uint32_t key;
+    uint32_t payload;
+};
+
+constexpr uint32_t EMPTY_KEY = 0xFFFFFFFFu; // Reserved: never used as a data key
+
+// Murmur3 finalizer: top bits pick the partition, low bits pick the slot, so the two are independent
+inline uint32_t hash32(uint32_t k) {
+    k ^= k >> 16;
+    k *= 0x85EBCA6Bu;
+    k ^= k >> 13;
+    k *= 0xC2B2AE35u;
+    k ^= k >> 16;
+    return k;
+}
+
+inline uint32_t partition_of(uint32_t key, int bits) {
+    return bits == 0 ? 0 : hash32(key) >> (32 - bits);
+}
+
+size_t l2_bytes() {
+    long v = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return v > 0 ? static_cast<size_t>(v) : 1u << 20;
+}
+
+size_t next_pow2(size_t x) {
+    size_t p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+// --- Radix partitioning ---
+
+struct Partitioned {
+    std::vector<Tuple> data;
+    std::vector<size_t> offsets; // Partition p is data[offsets[p], offsets[p + 1])
+};
+
+Partitioned radix_partition(const std::vector<Tuple>& in, int bits) {
+    const size_t parts = size_t(1) << bits;
+    const long n = static_cast<long>(in.size());
+    const int max_threads = omp_get_max_threads();
+    std::vector<size_t> cursor(static_cast<size_t>(max_threads) * parts, 0); // [thread][partition]
+    Partitioned out;
+    out.data.resize(in.size());
+    out.offsets.assign(parts + 1, 0);
+
+    #pragma omp parallel
+    {
+        const size_t t = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        size_t* mine = &cursor[t * parts];
+
+        // Pass 1: histogram of this thread's rows. schedule(static) on the same bounds gives each thread the same
+        // rows again in pass 2.
+        #pragma omp for schedule(static)
+        for (long i = 0; i < n; ++i) ++mine[partition_of(in[i].key, bits)];
+
+        // Prefix sums in partition-major order: partition p = thread 0's rows, then thread 1's, ...
+        #pragma omp single
+        {
+            size_t running = 0;
+            for (size_t p = 0; p < parts; ++p) {
+                out.offsets[p] = running;
+                for (int th = 0; th < threads; ++th) {
+                    size_t count = cursor[th * parts + p];
+                    cursor[th * parts + p] = running;
+                    running += count;
+                }
+            }
+            out.offsets[parts] = running;
+        } // Implicit barrier: every thread now owns disjoint output ranges
+
+        // Pass 2: scatter
+        #pragma omp for schedule(static)
+        for (long i = 0; i < n; ++i) out.data[mine[partition_of(in[i].key, bits)]++] = in[i];
+    }
+    return out;
+}
+
+// Enough partitions that one partition's table (2 slots per row, key + payload) fits in half of L2, and at least
+// a few partitions per thread for load balance
+int choose_partition_bits(size_t build_rows) {
+    size_t table_bytes = build_rows * 2 * sizeof(Tuple);
+    size_t budget = l2_bytes() / 2;
+    int bits = 0;
+    while ((table_bytes >> bits) > budget || (size_t(1) << bits) < size_t(4 * omp_get_max_threads())) ++bits;
+    return bits;
+}
+
+// --- Bucketized linear-probing table (groups of 8 slots = one AVX2 register of keys) ---
+
+class GroupTable {
+public:
+    explicit GroupTable(size_t rows) {
+        size_t groups = next_pow2(std::max<size_t>(1, (rows * 2 + 7) / 8)); // <= 50% full
+        group_mask_ = groups - 1;
+        void* p = nullptr;
+        if (posix_memalign(&p, 32, groups * 8 * sizeof(uint32_t)) != 0) throw std::bad_alloc();
+        keys_ = static_cast<uint32_t*>(p);
+        std::fill(keys_, keys_ + groups * 8, EMPTY_KEY);
+        payloads_.resize(groups * 8);
+    }
+    ~GroupTable() { std::free(keys_); }
+    GroupTable(const GroupTable&) = delete;
+    GroupTable& operator=(const GroupTable&) = delete;
+
+    void insert(uint32_t key, uint32_t payload) {
+        for (size_t g = hash32(key) & group_mask_;; g = (g + 1) & group_mask_) {
+            uint32_t* slots = keys_ + g * 8;
+            for (int s = 0; s < 8; ++s) {
+                if (slots[s] == EMPTY_KEY) {
+                    slots[s] = key;
+                    payloads_[g * 8 + s] = payload;
+                    return;
+                }
+            }
+        }
+    }
+
+    // Scalar probe: calls emit(payload) for every match
+    template<typename Emit>
+    void probe(uint32_t key, Emit emit) const {
+        for (size_t g = hash32(key) & group_mask_;; g = (g + 1) & group_mask_) {
+            const uint32_t* slots = keys_ + g * 8;
+            bool has_empty = false;
+            for (int s = 0; s < 8; ++s) {
+                if (slots[s] == key) emit(payloads_[g * 8 + s]);
+                has_empty |= slots[s] == EMPTY_KEY;
+            }
+            if (has_empty) return;
+        }
+    }
+
+    // AVX2 probe: one compare for the key, one for "empty", over the whole group
+    template<typename Emit>
+    __attribute__((target("avx2"))) void probe_avx2(uint32_t key, Emit emit) const {
+        const __m256i needle = _mm256_set1_epi32(static_cast<int>(key));
+        const __m256i empty = _mm256_set1_epi32(static_cast<int>(EMPTY_KEY));
+        for (size_t g = hash32(key) & group_mask_;; g = (g + 1) & group_mask_) {
+            __m256i slots = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys_ + g * 8));
+            unsigned hits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(slots, needle)));
+            unsigned empties = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(slots, empty)));
+            while (hits) {
+                emit(payloads_[g * 8 + __builtin_ctz(hits)]);
+                hits &= hits - 1;
+            }
+            if (empties) return;
+        }
+    }
+
+private:
+    uint32_t* keys_ = nullptr;
+    std::vector<uint32_t> payloads_;
+    size_t group_mask_ = 0;
+};
+
+struct JoinResult {
+    uint64_t matches = 0;
+    uint64_t checksum = 0; // Sum of r.payload + s.payload over all matches
+};
+
+// Join one partition pair: build on r, probe with s
+template<bool UseAvx2>
+void join_partition(const Tuple* r, size_t nr, const Tuple* s, size_t ns, JoinResult& result) {
+    GroupTable table(nr);
+    for (size_t i = 0; i < nr; ++i) table.insert(r[i].key, r[i].payload);
+    uint64_t matches = 0, checksum = 0;
+    for (size_t i = 0; i < ns; ++i) {
+        auto emit = [&](uint32_t payload) { ++matches; checksum += payload + s[i].payload; };
+        if constexpr (UseAvx2) table.probe_avx2(s[i].key, emit);
+        else table.probe(s[i].key, emit);
+    }
+    result.matches += matches;
+    result.checksum += checksum;
+}
+
+template<bool UseAvx2>
+JoinResult radix_join(const std::vector<Tuple>& r, const std::vector<Tuple>& s, int bits) {
+    Partitioned pr = radix_partition(r, bits);
+    Partitioned ps = radix_partition(s, bits);
+    const long parts = static_cast<long>(pr.offsets.size()) - 1;
+    uint64_t matches = 0, checksum = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:matches, checksum)
+    for (long p = 0; p < parts; ++p) {
+        JoinResult local;
+        join_partition<UseAvx2>(pr.data.data() + pr.offsets[p], pr.offsets[p + 1] - pr.offsets[p],
+                                ps.data.data() + ps.offsets[p], ps.offsets[p + 1] - ps.offsets[p], local);
+        matches += local.matches;
+        checksum += local.checksum;
+    }
+    return {matches, checksum};
+}
+
+// Without partitioning: one shared table over all of R, probed in parallel (every probe is a DRAM miss)
+JoinResult shared_table_join(const std::vector<Tuple>& r, const std::vector<Tuple>& s) {
+    GroupTable table(r.size());
+    for (const Tuple& t : r) table.insert(t.key, t.payload);
+    uint64_t matches = 0, checksum = 0;
+    const long ns = static_cast<long>(s.size());
+    #pragma omp parallel for schedule(static) reduction(+:matches, checksum)
+    for (long i = 0; i < ns; ++i) {
+        table.probe(s[i].key, [&](uint32_t payload) { ++matches; checksum += payload + s[i].payload; });
+    }
+    return {matches, checksum};
+}
+
+JoinResult naive_join(const std::vector<Tuple>& r, const std::vector<Tuple>& s) {
+    std::unordered_multimap<uint32_t, uint32_t> table;
+    table.reserve(r.size());
+    for (const Tuple& t : r) table.emplace(t.key, t.payload);
+    JoinResult result;
+    for (const Tuple& t : s) {
+        auto range = table.equal_range(t.key);
+        for (auto it = range.first; it != range.second; ++it) {
+            ++result.matches;
+            result.checksum += it->second + t.payload;
+        }
+    }
+    return result;
+}
+
+// --- Group-by: SUM(payload), COUNT(*) GROUP BY key ---
+
+struct Aggregate {
+    uint32_t key;
+    uint32_t count;
+    uint64_t sum;
+};
+
+// Open-addressing aggregation table with a fixed capacity (power of two, kept <= 50% full by the caller)
+class AggTable {
+public:
+    explicit AggTable(size_t capacity) : slots_(next_pow2(capacity)), mask_(slots_.size() - 1) {
+        for (auto& a : slots_) a.key = EMPTY_KEY;
+    }
+
+    void add(uint32_t key, uint32_t count, uint64_t sum) {
+        for (size_t i = hash32(key) & mask_;; i = (i + 1) & mask_) {
+            Aggregate& a = slots_[i];
+            if (a.key == key) { a.count += count; a.sum += sum; return; }
+            if (a.key == EMPTY_KEY) { a = {key, count, sum}; ++size_; return; }
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+
+    template<typename F>
+    void for_each(F f) const {
+        for (const Aggregate& a : slots_) {
+            if (a.key != EMPTY_KEY) f(a);
+        }
+    }
+
+    void clear() {
+        for (auto& a : slots_) a.key = EMPTY_KEY;
+        size_ = 0;
+    }
+
+private:
+    std::vector<Aggregate> slots_;
+    size_t mask_;
+    size_t size_ = 0;
+};
+
+struct GroupResult {
+    uint64_t groups = 0;
+    uint64_t checksum = 0; // Order-independent: sum over groups of key * 31 + count * 7 + sum
+};
+
+inline uint64_t group_hash(const Aggregate& a) { return uint64_t(a.key) * 31 + uint64_t(a.count) * 7 + a.sum; }
+
+GroupResult parallel_group_by(const std::vector<Tuple>& rows, int bits) {
+    const size_t parts = size_t(1) << bits;
+    const int max_threads = omp_get_max_threads();
+    const size_t local_capacity = l2_bytes() / sizeof(Aggregate); // Local table fills L2, flushed at 50%
+    std::vector<std::vector<std::vector<Aggregate>>> spills(max_threads, std::vector<std::vector<Aggregate>>(parts));
+    const long n = static_cast<long>(rows.size());
+
+    // Phase 1: thread-local pre-aggregation, spilling to partitions when the local table is half full
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        AggTable local(local_capacity);
+        auto spill = [&] {
+            local.for_each([&](const Aggregate& a) { spills[t][partition_of(a.key, bits)].push_back(a); });
+            local.clear();
+        };
+        #pragma omp for schedule(static)
+        for (long i = 0; i < n; ++i) {
+            local.add(rows[i].key, 1, rows[i].payload);
+            if (local.size() * 2 >= local.capacity()) spill();
+        }
+        spill();
+    }
+
+    // Phase 2: merge each partition's spilled partial aggregates (from all threads) into its final table
+    uint64_t groups = 0, checksum = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:groups, checksum)
+    for (long p = 0; p < static_cast<long>(parts); ++p) {
+        size_t entries = 0;
+        for (int t = 0; t < max_threads; ++t) entries += spills[t][p].size();
+        AggTable final_table(entries * 2 + 1);
+        for (int t = 0; t < max_threads; ++t) {
+            for (const Aggregate& a : spills[t][p]) final_table.add(a.key, a.count, a.sum);
+        }
+        final_table.for_each([&](const Aggregate& a) { ++groups; checksum += group_hash(a); });
+    }
+    return {groups, checksum};
+}
+
+GroupResult naive_group_by(const std::vector<Tuple>& rows) {
+    std::unordered_map<uint32_t, Aggregate> table;
+    for (const Tuple& t : rows) {
+        auto [it, inserted] = table.try_emplace(t.key, Aggregate{t.key, 0, 0});
+        it->second.count += 1;
+        it->second.sum += t.payload;
+    }
+    GroupResult result;
+    for (const auto& kv : table) {
+        ++result.groups;
+        result.checksum += group_hash(kv.second);
+    }
+    return result;
+}
+
+// --- Benchmark ---
+
+template<typename F>
+double time_ms(F fn, int reps = 3) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        double t0 = omp_get_wtime();
+        fn();
+        best = std::min(best, omp_get_wtime() - t0);
+    }
+    return best * 1e3;
+}
+
+void print_row(const char* name, double ms, size_t rows, double baseline_ms, bool ok) {
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << ms << " ms" << std::setw(9) << rows / (ms * 1e3) << " Mrows/s"
+              << std::setw(8) << std::setprecision(2) << baseline_ms / ms << "x" << (ok ? "" : "   WRONG RESULT") << std::endl;
+}
+
+int main() {
+    std::cout << "--- Parallel Hash Join and Group-By ---" << std::endl;
+    const size_t R_ROWS = 2 * 1024 * 1024, S_ROWS = 8 * 1024 * 1024;
+    const bool avx2 = __builtin_cpu_supports("avx2");
+    std::cout << "Threads: " << omp_get_max_threads() << ", L2: " << l2_bytes() / 1024 << " KiB, SIMD probe: "
+              << (avx2 ? "AVX2" : "scalar fallback") << std::endl;
+
+    // R: unique keys (primary key side). S: foreign keys, ~75% of them hit R.
+    std::mt19937 rng(7);
+    std::vector<uint32_t> keys(R_ROWS);
+    for (size_t i = 0; i < R_ROWS; ++i) keys[i] = static_cast<uint32_t>(i * 2654435761u % 0xFFFFFFF0u);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<Tuple> r(R_ROWS), s(S_ROWS);
+    for (size_t i = 0; i < R_ROWS; ++i) r[i] = {keys[i], static_cast<uint32_t>(i)};
+    std::uniform_int_distribution<size_t> pick(0, R_ROWS * 4 / 3);
+    for (size_t i = 0; i < S_ROWS; ++i) {
+        size_t k = pick(rng);
+        s[i] = {k < R_ROWS ? keys[k] : static_cast<uint32_t>(0xFFFFFFF0u + (k & 7)), static_cast<uint32_t>(i)};
+    }
+
+    const int bits = choose_partition_bits(R_ROWS);
+    std::cout << "\nJoin |R| = " << R_ROWS << ", |S| = " << S_ROWS << ", radix partitions: " << (1 << bits)
+              << " (~" << R_ROWS * 2 * sizeof(Tuple) / (size_t(1) << bits) / 1024 << " KiB table each)" << std::endl;
+    JoinResult expected, got;
+    double base = time_ms([&] { expected = naive_join(r, s); }, 1);
+    print_row("std::unordered_multimap, 1 thread", base, S_ROWS, base, true);
+    double t = time_ms([&] { got = shared_table_join(r, s); });
+    print_row("shared table, parallel probe", t, S_ROWS, base, got.matches == expected.matches && got.checksum == expected.checksum);
+    t = time_ms([&] { got = radix_join<false>(r, s, bits); });
+    print_row("radix join, scalar probe", t, S_ROWS, base, got.matches == expected.matches && got.checksum == expected.checksum);
+    if (avx2) {
+        t = time_ms([&] { got = radix_join<true>(r, s, bits); });
+        print_row("radix join, AVX2 probe", t, S_ROWS, base, got.matches == expected.matches && got.checksum == expected.checksum);
+    }
+    std::cout << "Matches: " << expected.matches << std::endl;
+
+    for (uint32_t cardinality : {1000u, 1u << 20}) {
+        std::vector<Tuple> rows(S_ROWS);
+        std::uniform_int_distribution<uint32_t> group(0, cardinality - 1);
+        for (size_t i = 0; i < S_ROWS; ++i) rows[i] = {group(rng) * 2654435761u % 0xFFFFFFF0u, static_cast<uint32_t>(i & 0xFFFF)};
+        const int gbits = choose_partition_bits(std::min<size_t>(cardinality, S_ROWS));
+        std::cout << "\nGroup-by " << S_ROWS << " rows into ~" << cardinality << " groups, " << (1 << gbits) << " partitions" << std::endl;
+        GroupResult gexp, ggot;
+        base = time_ms([&] { gexp = naive_group_by(rows); }, 1);
+        print_row("std::unordered_map, 1 thread", base, S_ROWS, base, true);
+        t = time_ms([&] { ggot = parallel_group_by(rows, gbits); });
+        print_row("local pre-agg + partitioned merge", t, S_ROWS, base, ggot.groups == gexp.groups && ggot.checksum == gexp.checksum);
+        std::cout << "Groups: " << gexp.groups << std::endl;
+    }
+    return 0;
+}
+
+// Compile (GCC/Clang): g++ 9_hash_join_groupby.cpp -o bin/hash_join_groupby -fopenmp -O2 -std=c++17
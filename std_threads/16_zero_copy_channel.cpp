@@ -0,0 +1,333 @@
+// Zero-Copy Message Channel with Ownership Transfer
+// Concept: ThreadSafeQueue<T>::push(T item) (06_task_queue.cpp) moves each item into a std::queue whose deque
+// allocates nodes, and a large payload is copied if the caller forgets std::move. Here the channel owns a fixed
+// set of pre-allocated message slots instead:
+//   producer: acquire() a free slot -> write the payload in place -> publish() the handle
+//   consumer: receive() a handle    -> read the payload in place  -> release (automatic when the handle dies)
+// Only a 32-bit slot index travels through two lock-free rings (free list and ready list), so in steady state
+// there is no allocation and no payload copy. Handles are move-only: whoever holds one owns the slot.
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// --- Global allocation counter, to show the steady state really is allocation-free ---
+std::atomic<long> allocation_count{0};
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Bounded lock-free MPMC ring of slot indices (Dmitry Vyukov's sequence-number design)
+class IndexRing {
+public:
+    explicit IndexRing(size_t min_capacity) {
+        size_t cap = 1;
+        while (cap < min_capacity) cap <<= 1;
+        mask = cap - 1;
+        cells = std::make_unique<Cell[]>(cap);
+        for (size_t i = 0; i < cap; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(uint32_t value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release); // Publish to consumers
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(uint32_t& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.seq.store(pos + mask + 1, std::memory_order_release); // Hand cell back to producers
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        uint32_t value;
+    };
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0}; // Separate cache lines: producers and consumers don't false-share
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+class MessageChannel {
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // Producer-side handle: an exclusively owned, writable slot
+    class WriteSlot {
+    public:
+        WriteSlot() = default;
+        WriteSlot(WriteSlot&& other) noexcept : channel(other.channel), slot(other.slot) { other.slot = NO_SLOT; }
+        WriteSlot& operator=(WriteSlot&& other) noexcept {
+            if (this != &other) { abandon(); channel = other.channel; slot = other.slot; other.slot = NO_SLOT; }
+            return *this;
+        }
+        ~WriteSlot() { abandon(); }
+
+        unsigned char* data() { return channel->slot_data(slot); }
+        size_t capacity() const { return channel->slot_bytes; }
+        explicit operator bool() const { return slot != NO_SLOT; }
+
+    private:
+        friend class MessageChannel;
+        WriteSlot(MessageChannel* c, uint32_t s) : channel(c), slot(s) {}
+        void abandon() { if (slot != NO_SLOT) { channel->free_slot(slot); slot = NO_SLOT; } } // Never published
+        MessageChannel* channel = nullptr;
+        uint32_t slot = NO_SLOT;
+    };
+
+    // Consumer-side handle: read-only view; the slot returns to the free list when the handle is destroyed
+    class ReadSlot {
+    public:
+        ReadSlot() = default;
+        ReadSlot(ReadSlot&& other) noexcept : channel(other.channel), slot(other.slot) { other.slot = NO_SLOT; }
+        ReadSlot& operator=(ReadSlot&& other) noexcept {
+            if (this != &other) { release(); channel = other.channel; slot = other.slot; other.slot = NO_SLOT; }
+            return *this;
+        }
+        ~ReadSlot() { release(); }
+
+        const unsigned char* data() const { return channel->slot_data(slot); }
+        size_t size() const { return channel->sizes[slot]; }
+        explicit operator bool() const { return slot != NO_SLOT; }
+
+        void release() { if (slot != NO_SLOT) { channel->free_slot(slot); slot = NO_SLOT; } }
+
+    private:
+        friend class MessageChannel;
+        ReadSlot(MessageChannel* c, uint32_t s) : channel(c), slot(s) {}
+        MessageChannel* channel = nullptr;
+        uint32_t slot = NO_SLOT;
+    };
+
+    MessageChannel(size_t num_slots, size_t slotBytes)
+        : slot_bytes(slotBytes), stride((slotBytes + 63) & ~size_t(63)),
+          free_ring(num_slots), ready_ring(num_slots), sizes(new size_t[num_slots]) {
+        storage = static_cast<unsigned char*>(std::aligned_alloc(64, stride * num_slots));
+        if (!storage) throw std::bad_alloc();
+        for (uint32_t i = 0; i < num_slots; ++i) free_ring.try_push(i);
+    }
+
+    ~MessageChannel() { std::free(storage); }
+
+    MessageChannel(const MessageChannel&) = delete;
+    MessageChannel& operator=(const MessageChannel&) = delete;
+
+    // Blocks (spin + yield) until a slot is free; returns an empty handle once the channel is closed
+    WriteSlot acquire() {
+        uint32_t slot;
+        while (!free_ring.try_pop(slot)) {
+            if (closed.load(std::memory_order_acquire)) return WriteSlot();
+            std::this_thread::yield();
+        }
+        return WriteSlot(this, slot);
+    }
+
+    // Transfers ownership of the written slot to the consumers
+    void publish(WriteSlot&& w, size_t size) {
+        sizes[w.slot] = size;
+        uint32_t slot = w.slot;
+        w.slot = NO_SLOT;
+        while (!ready_ring.try_push(slot)) std::this_thread::yield(); // Cannot stay full: slots <= capacity
+    }
+
+    // Blocks until a message is ready; returns an empty handle when closed and drained
+    ReadSlot receive() {
+        uint32_t slot;
+        while (!ready_ring.try_pop(slot)) {
+            if (closed.load(std::memory_order_acquire)) {
+                if (ready_ring.try_pop(slot)) break; // A publish raced with close()
+                return ReadSlot();
+            }
+            std::this_thread::yield();
+        }
+        return ReadSlot(this, slot);
+    }
+
+    void close() { closed.store(true, std::memory_order_release); }
+
+private:
+    unsigned char* slot_data(uint32_t slot) const { return storage + static_cast<size_t>(slot) * stride; }
+    void free_slot(uint32_t slot) { while (!free_ring.try_push(slot)) std::this_thread::yield(); }
+
+    size_t slot_bytes;
+    size_t stride; // Slot size rounded to a cache line so neighbouring slots never share one
+    unsigned char* storage;
+    IndexRing free_ring;
+    IndexRing ready_ring;
+    std::unique_ptr<size_t[]> sizes;
+    std::atomic<bool> closed{false};
+};
+
+// --- Baseline: the ThreadSafeQueue from 06_task_queue.cpp carrying std::vector payloads ---
+template<typename T>
+class ThreadSafeQueue {
+private:
+    std::queue<T> q;
+    mutable std::mutex mtx;
+    std::condition_variable cv_consumer;
+    std::condition_variable cv_producer;
+    size_t max_size;
+    std::atomic<bool> finished = false;
+
+public:
+    ThreadSafeQueue(size_t maxSize = 1000) : max_size(maxSize) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_producer.wait(lock, [this]{ return q.size() < max_size || finished; });
+        if (finished) return;
+        q.push(std::move(item));
+        lock.unlock();
+        cv_consumer.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_consumer.wait(lock, [this]{ return !q.empty() || finished; });
+        if (q.empty()) return std::nullopt;
+        T item = std::move(q.front());
+        q.pop();
+        lock.unlock();
+        cv_producer.notify_one();
+        return item;
+    }
+
+    void set_finished() {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+        cv_consumer.notify_all();
+        cv_producer.notify_all();
+    }
+};
+
+// Producer "generates" each message: fill the payload with a per-message byte pattern
+inline void fill_payload(unsigned char* p, size_t size, long seq) {
+    std::memset(p, static_cast<int>(seq & 0xFF), size);
+}
+
+inline uint64_t consume_payload(const unsigned char* p, size_t size) {
+    return static_cast<uint64_t>(p[0]) + p[size - 1]; // Touch both ends of the message
+}
+
+struct Result {
+    double seconds;
+    long allocations;
+    bool ok;
+};
+
+Result run_queue(size_t msg_size, long messages) {
+    ThreadSafeQueue<std::vector<unsigned char>> queue(64);
+    uint64_t checksum = 0;
+    long allocs_before = allocation_count.load();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread consumer([&] {
+        while (std::optional<std::vector<unsigned char>> msg = queue.pop()) {
+            checksum += consume_payload(msg->data(), msg->size());
+        }
+    });
+    for (long i = 0; i < messages; ++i) {
+        std::vector<unsigned char> msg(msg_size); // One allocation (plus zero-fill) per message
+        fill_payload(msg.data(), msg_size, i);
+        queue.push(std::move(msg));
+    }
+    queue.set_finished();
+    consumer.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    uint64_t expected = 0;
+    for (long i = 0; i < messages; ++i) expected += 2 * static_cast<uint64_t>(i & 0xFF);
+    return {std::chrono::duration<double>(end - start).count(), allocation_count.load() - allocs_before, checksum == expected};
+}
+
+Result run_channel(MessageChannel& channel, size_t msg_size, long messages) {
+    uint64_t checksum = 0;
+    std::thread consumer([&] {
+        while (MessageChannel::ReadSlot msg = channel.receive()) {
+            checksum += consume_payload(msg.data(), msg.size());
+        } // Slot released here, back to the producer's free list
+    });
+
+    long allocs_before = allocation_count.load(); // Thread start-up allocations are not steady state
+    auto start = std::chrono::high_resolution_clock::now();
+    for (long i = 0; i < messages; ++i) {
+        MessageChannel::WriteSlot slot = channel.acquire();
+        fill_payload(slot.data(), msg_size, i); // Written in place, directly into the shared slot
+        channel.publish(std::move(slot), msg_size);
+    }
+    channel.close();
+    consumer.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    long allocs = allocation_count.load() - allocs_before;
+
+    uint64_t expected = 0;
+    for (long i = 0; i < messages; ++i) expected += 2 * static_cast<uint64_t>(i & 0xFF);
+    return {std::chrono::duration<double>(end - start).count(), allocs, checksum == expected};
+}
+
+int main() {
+    std::cout << "Zero-copy channel vs ThreadSafeQueue<std::vector> (1 producer, 1 consumer)" << std::endl;
+    std::cout << "size      queue msg/s   channel msg/s   speedup   queue allocs   channel allocs" << std::endl;
+
+    for (size_t msg_size : {64, 256, 1024, 4096, 16384, 65536}) {
+        const long messages = static_cast<long>(std::max<size_t>(20'000, (512UL << 20) / msg_size / 4));
+
+        Result q = run_queue(msg_size, messages);
+        MessageChannel channel(64, msg_size); // Constructed outside the measured region
+        Result c = run_channel(channel, msg_size, messages);
+
+        std::cout << msg_size << "\t  " << static_cast<long>(messages / q.seconds) << "\t  "
+                  << static_cast<long>(messages / c.seconds) << "\t  " << q.seconds / c.seconds << "x\t    "
+                  << q.allocations << "\t\t   " << c.allocations
+                  << (q.ok && c.ok ? "" : "   CHECKSUM MISMATCH") << std::endl;
+    }
+    return 0;
+}
+// Compile with: g++ 16_zero_copy_channel.cpp -o bin/zero_copy_channel -pthread -std=c++17 -O2
@@ -0,0 +1,435 @@
+// Thread-per-Core Reactors with epoll (Network I/O + Thread Pool Hand-off)
+// Concept: Each reactor thread is pinned to a core and owns an epoll loop, its own SO_REUSEPORT listening socket
+// (the kernel spreads new connections across the listeners) and every connection it accepted. Cheap requests are
+// answered inline on the reactor. CPU-heavy requests are handed to SimpleThreadPool (14_simple_threadpool.cpp) so
+// they never stall the event loop; the worker posts the result back to the OWNING reactor through a completion
+// queue + eventfd, and only that reactor ever touches the connection's socket and state - no locks on the I/O path.
+// Benchmark: loopback clients in a closed loop (send, wait for reply) report requests/s and p50/p99 latency.
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Fixed-size frames keep the protocol trivial: byte 0 is the request type, the rest is payload
+constexpr size_t FRAME = 64;
+constexpr unsigned char REQ_ECHO = 'E';
+constexpr unsigned char REQ_HASH = 'H'; // CPU-heavy: iterated hash of the payload
+
+// --- SimpleThreadPool from 14_simple_threadpool.cpp (logging removed) ---
+class SimpleThreadPool {
+public:
+    SimpleThreadPool(size_t numThreads) : stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(this->queue_mutex);
+                        this->condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
+                        if (this->stop && this->tasks.empty()) return;
+                        task = std::move(this->tasks.front());
+                        this->tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    void enqueue(std::function<void()> f) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stop) return;
+            tasks.emplace(std::move(f));
+        }
+        condition.notify_one();
+    }
+
+    ~SimpleThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+};
+
+uint64_t heavy_hash(const unsigned char* data, size_t len, int rounds) {
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < len; ++i) {
+            h ^= data[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int make_listener(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)); // Each reactor gets its own accept queue
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 1024) != 0) {
+        throw std::runtime_error(std::string("listener: ") + std::strerror(errno));
+    }
+    set_nonblocking(fd);
+    return fd;
+}
+
+class Reactor {
+public:
+    Reactor(int listen_fd, SimpleThreadPool& pool, int hash_rounds)
+        : listen_fd(listen_fd), pool(pool), hash_rounds(hash_rounds) {
+        epfd = epoll_create1(0);
+        wake_fd = eventfd(0, EFD_NONBLOCK);
+        add(listen_fd, EPOLLIN);
+        add(wake_fd, EPOLLIN);
+    }
+
+    ~Reactor() {
+        for (auto& [fd, conn] : connections) close(fd);
+        close(wake_fd);
+        close(epfd);
+        close(listen_fd);
+    }
+
+    void start(int cpu) {
+        thread = std::thread([this, cpu] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // Thread-per-core
+            run();
+        });
+    }
+
+    void stop() {
+        stopping.store(true);
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0) { /* Counter already non-zero: loop will wake anyway */ }
+        thread.join();
+    }
+
+    long served() const { return requests.load(std::memory_order_relaxed); }
+    long offloaded() const { return offloads.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        uint64_t generation;   // Guards against completions for a closed fd that was since reused
+        std::string in;        // Partial frames
+        std::string out;       // Bytes the socket would not take yet
+        int in_flight = 0;     // Requests offloaded to the pool and not yet answered
+        bool peer_done = false; // Read side hit EOF: answer what is pending, then close
+    };
+
+    struct Completion {
+        int fd;
+        uint64_t generation;
+        unsigned char frame[FRAME];
+    };
+
+    void add(int fd, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void run() {
+        epoll_event events[128];
+        while (!stopping.load()) {
+            int n = epoll_wait(epfd, events, 128, 100);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listen_fd) accept_all();
+                else if (fd == wake_fd) drain_completions();
+                else {
+                    if (events[i].events & EPOLLOUT) flush(fd);
+                    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) on_readable(fd);
+                }
+            }
+        }
+    }
+
+    void accept_all() {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) return; // EAGAIN: accept queue drained
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            connections[fd] = Connection{next_generation++, {}, {}, 0, false};
+            add(fd, EPOLLIN);
+        }
+    }
+
+    void on_readable(int fd) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        char buf[4096];
+        while (!it->second.peer_done) {
+            ssize_t r = read(fd, buf, sizeof(buf));
+            if (r > 0) { it->second.in.append(buf, static_cast<size_t>(r)); continue; }
+            if (r == 0) { it->second.peer_done = true; break; } // Frames that came with the EOF are still answered
+            if (errno != EAGAIN && errno != EWOULDBLOCK) { close_connection(fd); return; }
+            break;
+        }
+        std::string& in = it->second.in;
+        size_t pos = 0;
+        for (; pos + FRAME <= in.size(); pos += FRAME) {
+            if (!handle_request(fd, it->second, reinterpret_cast<const unsigned char*>(in.data() + pos))) return;
+        }
+        in.erase(0, pos);
+        if (it->second.peer_done) finish_if_idle(fd, it->second);
+    }
+
+    // False if replying failed and the connection was closed
+    bool handle_request(int fd, Connection& conn, const unsigned char* frame) {
+        if (frame[0] != REQ_HASH) {
+            requests.fetch_add(1, std::memory_order_relaxed);
+            return send_frame(fd, conn, frame); // Echo: cheap, answered inline
+        }
+        // CPU-heavy: off the reactor thread, completion comes back through our eventfd
+        offloads.fetch_add(1, std::memory_order_relaxed);
+        ++conn.in_flight;
+        auto c = std::make_shared<Completion>();
+        c->fd = fd;
+        c->generation = conn.generation;
+        std::memcpy(c->frame, frame, FRAME);
+        pool.enqueue([this, c] {
+            uint64_t h = heavy_hash(c->frame + 1, FRAME - 1, hash_rounds);
+            std::memcpy(c->frame + 1, &h, sizeof(h));
+            post_completion(std::move(*c));
+        });
+        return true;
+    }
+
+    // Called on pool threads
+    void post_completion(Completion&& c) {
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex);
+            completions.push_back(std::move(c));
+        }
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0) { /* eventfd counter saturated: already signalled */ }
+    }
+
+    void drain_completions() {
+        uint64_t count;
+        if (read(wake_fd, &count, sizeof(count)) < 0) { /* Spurious wake */ }
+        std::vector<Completion> ready;
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex);
+            ready.swap(completions);
+        }
+        for (Completion& c : ready) {
+            auto it = connections.find(c.fd);
+            if (it == connections.end() || it->second.generation != c.generation) continue; // Client went away
+            --it->second.in_flight;
+            requests.fetch_add(1, std::memory_order_relaxed);
+            if (send_frame(c.fd, it->second, c.frame)) finish_if_idle(c.fd, it->second);
+        }
+    }
+
+    // send() with MSG_NOSIGNAL: a client that disconnected must cost us EPIPE on its own connection, not a SIGPIPE
+    // that kills the whole process. Returns -1 only for real errors (EAGAIN counts as 0 bytes).
+    static ssize_t send_some(int fd, const char* data, size_t len) {
+        ssize_t w = send(fd, data, len, MSG_NOSIGNAL);
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        return w;
+    }
+
+    // False if the peer is gone (EPIPE, ECONNRESET...) and the connection was closed
+    bool send_frame(int fd, Connection& conn, const unsigned char* frame) {
+        if (!conn.out.empty()) { // Preserve ordering behind already-buffered output
+            conn.out.append(reinterpret_cast<const char*>(frame), FRAME);
+            return true;
+        }
+        ssize_t w = send_some(fd, reinterpret_cast<const char*>(frame), FRAME);
+        if (w < 0) { close_connection(fd); return false; }
+        if (w == static_cast<ssize_t>(FRAME)) return true;
+        conn.out.append(reinterpret_cast<const char*>(frame) + w, FRAME - static_cast<size_t>(w));
+        update_interest(fd, conn);
+        return true;
+    }
+
+    void flush(int fd) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        std::string& out = it->second.out;
+        ssize_t w = send_some(fd, out.data(), out.size());
+        if (w < 0) { close_connection(fd); return; }
+        out.erase(0, static_cast<size_t>(w));
+        if (out.empty()) {
+            update_interest(fd, it->second);
+            finish_if_idle(fd, it->second);
+        }
+    }
+
+    // Read interest until EOF (level-triggered EOF would otherwise spin), write interest while output is queued
+    void update_interest(int fd, const Connection& conn) {
+        epoll_event ev{};
+        ev.events = (conn.peer_done ? 0u : EPOLLIN) | (conn.out.empty() ? 0u : EPOLLOUT);
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
+    }
+
+    // After EOF: close once every request has been answered and flushed
+    void finish_if_idle(int fd, Connection& conn) {
+        if (!conn.peer_done) return;
+        if (conn.in_flight == 0 && conn.out.empty()) close_connection(fd);
+        else update_interest(fd, conn);
+    }
+
+    void close_connection(int fd) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    int listen_fd;
+    int epfd;
+    int wake_fd;
+    SimpleThreadPool& pool;
+    int hash_rounds;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::unordered_map<int, Connection> connections; // Touched only by this reactor's thread
+    uint64_t next_generation = 1;
+
+    std::mutex completion_mutex;
+    std::vector<Completion> completions;
+
+    std::atomic<long> requests{0};
+    std::atomic<long> offloads{0};
+};
+
+// --- Loopback client: closed loop, one outstanding request per connection ---
+void client(uint16_t port, int heavy_every, std::chrono::steady_clock::time_point deadline, std::vector<double>& latencies_us) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "connect: " << std::strerror(errno) << std::endl;
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    unsigned char req[FRAME], resp[FRAME];
+    std::memset(req, 'x', FRAME);
+    for (long i = 0; std::chrono::steady_clock::now() < deadline; ++i) {
+        req[0] = (heavy_every > 0 && i % heavy_every == 0) ? REQ_HASH : REQ_ECHO;
+        auto t0 = std::chrono::steady_clock::now();
+        if (send(fd, req, FRAME, MSG_NOSIGNAL) != static_cast<ssize_t>(FRAME)) break;
+        size_t got = 0;
+        while (got < FRAME) {
+            ssize_t r = read(fd, resp + got, FRAME - got);
+            if (r <= 0) { close(fd); return; }
+            got += static_cast<size_t>(r);
+        }
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+    }
+    close(fd);
+}
+
+int main() {
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    const int reactors_n = cores;
+    const int clients_n = 4 * reactors_n;
+    const int heavy_every = 10;     // 1 in 10 requests is CPU-heavy
+    const int hash_rounds = 2000;   // ~tens of microseconds of work
+    const auto duration = std::chrono::seconds(2);
+
+    // Declared before the pool so they are destroyed after it: ~SimpleThreadPool runs every queued offload, and
+    // those capture their Reactor and post to its wake_fd
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    SimpleThreadPool pool(cores);
+
+    // All listeners share one port; the kernel load-balances incoming connections across them
+    std::vector<int> listeners;
+    listeners.push_back(make_listener(0));
+    sockaddr_in bound{};
+    socklen_t len = sizeof(bound);
+    getsockname(listeners[0], reinterpret_cast<sockaddr*>(&bound), &len);
+    uint16_t port = ntohs(bound.sin_port);
+    for (int i = 1; i < reactors_n; ++i) listeners.push_back(make_listener(port));
+
+    for (int i = 0; i < reactors_n; ++i) {
+        reactors.push_back(std::make_unique<Reactor>(listeners[i], pool, hash_rounds));
+        reactors.back()->start(i % cores);
+    }
+    std::cout << reactors_n << " reactors on port " << port << ", " << clients_n << " client connections, "
+              << "1 in " << heavy_every << " requests offloaded to the pool" << std::endl;
+
+    std::vector<std::vector<double>> latencies(clients_n);
+    std::vector<std::thread> clients;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < clients_n; ++i) {
+        clients.emplace_back(client, port, heavy_every, start + duration, std::ref(latencies[i]));
+    }
+    for (std::thread& c : clients) c.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+
+    for (auto& r : reactors) {
+        std::cout << "Reactor served " << r->served() << " requests (" << r->offloaded() << " offloaded)" << std::endl;
+    }
+    for (auto& r : reactors) r->stop();
+
+    if (all.empty()) {
+        std::cout << "No requests completed." << std::endl;
+        return 1;
+    }
+    std::cout << "Requests/s: " << static_cast<long>(all.size() / elapsed) << std::endl;
+    std::cout << "Latency p50: " << all[all.size() / 2] << " us, p99: " << all[all.size() * 99 / 100]
+              << " us, max: " << all.back() << " us" << std::endl;
+    return 0;
+}
+// Compile with: g++ 18_reactor_event_loop.cpp -o bin/reactor_event_loop -pthread -std=c++17 -O2 (Linux: epoll, eventfd)
@@ -0,0 +1,403 @@
+// High-Dynamic-Range (HDR) Latency Histograms
+// Concept: A single duration.count() hides the tail. An HDR histogram records every sample into log-linear buckets
+// (fixed relative precision, e.g. 3 significant digits, from 1 ns up to minutes) in O(1) with no allocation, so
+// p50/p99/p99.9/max can be read off at the end.
+//   - Record path: each thread writes only its own histogram (single-writer relaxed load+store, no lock, no RMW).
+//   - Snapshots: the per-thread histograms are merged on demand into one plain histogram.
+//   - Histograms serialize to a compact text form (non-zero buckets only) and deserialize back, e.g. to merge
+//     results from several processes or runs.
+// The same recorder is used below by a queue (time spent waiting in the queue), a thread pool (queueing delay and
+// run time per task) and a small benchmark harness.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+
+class HdrHistogram {
+public:
+    // Tracks values in [1, highest] with 'digits' significant decimal digits of precision (1..5)
+    HdrHistogram(uint64_t highest = 60'000'000'000ULL, int digits = 3) : highest(highest), digits(digits) {
+        if (digits < 1 || digits > 5 || highest < 2) throw std::invalid_argument("HdrHistogram: bad configuration");
+        uint64_t largest_single_unit = 2 * static_cast<uint64_t>(std::pow(10, digits));
+        sub_bucket_count_magnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largest_single_unit))));
+        sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+        sub_bucket_count = 1ULL << sub_bucket_count_magnitude;
+        sub_bucket_half_count = sub_bucket_count / 2;
+        sub_bucket_mask = sub_bucket_count - 1;
+
+        uint64_t smallest_untrackable = sub_bucket_count;
+        int buckets = 1;
+        while (smallest_untrackable <= highest) {
+            smallest_untrackable <<= 1;
+            ++buckets;
+        }
+        counts_len = static_cast<size_t>(buckets + 1) * sub_bucket_half_count;
+        counts = std::make_unique<std::atomic<uint64_t>[]>(counts_len);
+        reset();
+    }
+
+    HdrHistogram(const HdrHistogram& other) : HdrHistogram(other.highest, other.digits) { add(other); }
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+    // Single writer only (the owning thread); concurrent readers may call add()/percentile() on it
+    void record(uint64_t value) {
+        value = std::clamp<uint64_t>(value, 1, highest);
+        bump(counts[counts_index(value)], 1);
+        bump(total, 1);
+        if (value > max_value.load(std::memory_order_relaxed)) max_value.store(value, std::memory_order_relaxed);
+    }
+
+    // Merge 'other' into this histogram (same configuration required)
+    void add(const HdrHistogram& other) {
+        if (other.counts_len != counts_len) throw std::invalid_argument("HdrHistogram: incompatible merge");
+        for (size_t i = 0; i < counts_len; ++i) {
+            uint64_t c = other.counts[i].load(std::memory_order_relaxed);
+            if (c) counts[i].fetch_add(c, std::memory_order_relaxed);
+        }
+        total.fetch_add(other.count(), std::memory_order_relaxed);
+        uint64_t m = other.max();
+        uint64_t cur = max_value.load(std::memory_order_relaxed);
+        while (m > cur && !max_value.compare_exchange_weak(cur, m, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (size_t i = 0; i < counts_len; ++i) counts[i].store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max_value.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_value.load(std::memory_order_relaxed); }
+
+    // Value at the given percentile (0..100), reported as the highest value equivalent to its bucket
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(n))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_len; ++i) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= target) return std::min(highest_equivalent(value_from_index(i)), max());
+        }
+        return max();
+    }
+
+    // Text form: "HDR <highest> <digits> <total> <max>" followed by "index:count" for non-zero buckets
+    std::string serialize() const {
+        std::ostringstream out;
+        out << "HDR " << highest << ' ' << digits << ' ' << count() << ' ' << max();
+        for (size_t i = 0; i < counts_len; ++i) {
+            uint64_t c = counts[i].load(std::memory_order_relaxed);
+            if (c) out << ' ' << i << ':' << c;
+        }
+        return out.str();
+    }
+
+    static HdrHistogram deserialize(const std::string& text) {
+        std::istringstream in(text);
+        std::string magic;
+        uint64_t hi, n, mx;
+        int d;
+        if (!(in >> magic >> hi >> d >> n >> mx) || magic != "HDR") throw std::invalid_argument("HdrHistogram: bad input");
+        HdrHistogram h(hi, d);
+        size_t index;
+        uint64_t c;
+        char colon;
+        while (in >> index >> colon >> c) {
+            if (index >= h.counts_len) throw std::invalid_argument("HdrHistogram: bucket out of range");
+            h.counts[index].store(c, std::memory_order_relaxed);
+        }
+        h.total.store(n, std::memory_order_relaxed);
+        h.max_value.store(mx, std::memory_order_relaxed);
+        return h;
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t by) {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed); // Single writer: no lock prefix
+    }
+
+    int bucket_index(uint64_t value) const {
+        int pow2ceiling = 64 - __builtin_clzll(value | sub_bucket_mask);
+        return pow2ceiling - (sub_bucket_half_count_magnitude + 1);
+    }
+
+    size_t counts_index(uint64_t value) const {
+        int bucket = bucket_index(value);
+        uint64_t sub_bucket = value >> bucket;
+        return (static_cast<size_t>(bucket + 1) << sub_bucket_half_count_magnitude) + (sub_bucket - sub_bucket_half_count);
+    }
+
+    uint64_t value_from_index(size_t index) const {
+        int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude) - 1;
+        uint64_t sub_bucket = (index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+        if (bucket < 0) {
+            sub_bucket -= sub_bucket_half_count;
+            bucket = 0;
+        }
+        return sub_bucket << bucket;
+    }
+
+    uint64_t highest_equivalent(uint64_t value) const {
+        int bucket = bucket_index(value);
+        uint64_t sub_bucket = value >> bucket;
+        int adjusted = sub_bucket >= sub_bucket_count ? bucket + 1 : bucket;
+        uint64_t range = 1ULL << adjusted;
+        return (value & ~(range - 1)) + range - 1;
+    }
+
+    uint64_t highest;
+    int digits;
+    int sub_bucket_count_magnitude;
+    int sub_bucket_half_count_magnitude;
+    uint64_t sub_bucket_count;
+    uint64_t sub_bucket_half_count;
+    uint64_t sub_bucket_mask;
+    size_t counts_len;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> max_value{0};
+};
+
+// One histogram per recording thread; record() is lock-free after a thread's first sample.
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(std::string name) : name(std::move(name)), id(next_id.fetch_add(1)) {}
+
+    void record(uint64_t nanos) { local().record(nanos); }
+
+    void record(std::chrono::steady_clock::duration d) {
+        record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+    }
+
+    // Merged view of every thread's samples so far; safe to call while threads keep recording
+    HdrHistogram snapshot() const {
+        HdrHistogram merged;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto& h : per_thread) merged.add(*h);
+        return merged;
+    }
+
+    void report(std::ostream& os = std::cout) const { print_report(os, name, snapshot()); }
+
+    static void print_report(std::ostream& os, const std::string& label, const HdrHistogram& h) {
+        auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        os << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2)
+           << " n=" << std::setw(8) << h.count()
+           << "  p50=" << std::setw(9) << us(h.percentile(50)) << "us"
+           << "  p99=" << std::setw(9) << us(h.percentile(99)) << "us"
+           << "  p99.9=" << std::setw(9) << us(h.percentile(99.9)) << "us"
+           << "  max=" << std::setw(10) << us(h.max()) << "us" << std::endl;
+    }
+
+private:
+    HdrHistogram& local() {
+        thread_local std::vector<HdrHistogram*> cache; // Indexed by recorder id
+        if (id < cache.size() && cache[id]) return *cache[id];
+        if (cache.size() <= id) cache.resize(id + 1, nullptr);
+        std::lock_guard<std::mutex> lock(registry_mutex); // Once per thread per recorder
+        per_thread.push_back(std::make_unique<HdrHistogram>());
+        cache[id] = per_thread.back().get();
+        return *cache[id];
+    }
+
+    std::string name;
+    size_t id;
+    mutable std::mutex registry_mutex;
+    std::vector<std::unique_ptr<HdrHistogram>> per_thread;
+    static inline std::atomic<size_t> next_id{0};
+};
+
+// --- ThreadSafeQueue (06_task_queue.cpp) recording how long each item waited in the queue ---
+template<typename T>
+class ThreadSafeQueue {
+private:
+    using Clock = std::chrono::steady_clock;
+    std::queue<std::pair<T, Clock::time_point>> q;
+    mutable std::mutex mtx;
+    std::condition_variable cv_consumer;
+    std::condition_variable cv_producer;
+    size_t max_size;
+    std::atomic<bool> finished = false;
+    LatencyRecorder* wait_latency; // Optional
+
+public:
+    ThreadSafeQueue(size_t maxSize = 1000, LatencyRecorder* recorder = nullptr) : max_size(maxSize), wait_latency(recorder) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_producer.wait(lock, [this]{ return q.size() < max_size || finished; });
+        if (finished) return;
+        q.emplace(std::move(item), Clock::now());
+        lock.unlock();
+        cv_consumer.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_consumer.wait(lock, [this]{ return !q.empty() || finished; });
+        if (q.empty()) return std::nullopt;
+        auto [item, enqueued] = std::move(q.front());
+        q.pop();
+        lock.unlock();
+        cv_producer.notify_one();
+        if (wait_latency) wait_latency->record(Clock::now() - enqueued);
+        return std::move(item);
+    }
+
+    void set_finished() {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+        cv_consumer.notify_all();
+        cv_producer.notify_all();
+    }
+};
+
+// --- SimpleThreadPool (14_simple_threadpool.cpp) recording queueing delay and run time per task ---
+class SimpleThreadPool {
+public:
+    SimpleThreadPool(size_t numThreads) : queue_delay("pool: queueing delay"), run_time("pool: task run time"), stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::pair<std::function<void()>, std::chrono::steady_clock::time_point> task;
+                    {
+                        std::unique_lock<std::mutex> lock(this->queue_mutex);
+                        this->condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
+                        if (this->stop && this->tasks.empty()) return;
+                        task = std::move(this->tasks.front());
+                        this->tasks.pop();
+                    }
+                    auto started = std::chrono::steady_clock::now();
+                    queue_delay.record(started - task.second);
+                    task.first();
+                    run_time.record(std::chrono::steady_clock::now() - started);
+                }
+            });
+        }
+    }
+
+    void enqueue(std::function<void()> f) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stop) return;
+            tasks.emplace(std::move(f), std::chrono::steady_clock::now());
+        }
+        condition.notify_one();
+    }
+
+    ~SimpleThreadPool() { shutdown(); }
+
+    // Runs every queued task and joins the workers; after this returns both recorders are complete
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    LatencyRecorder queue_delay;
+    LatencyRecorder run_time;
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::pair<std::function<void()>, std::chrono::steady_clock::time_point>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+};
+
+// --- Benchmark harness: every operation is timed individually ---
+template<typename Op>
+HdrHistogram benchmark(const std::string& name, int threads, long ops_per_thread, Op op) {
+    LatencyRecorder recorder(name);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (long i = 0; i < ops_per_thread; ++i) {
+                auto t0 = std::chrono::steady_clock::now();
+                op();
+                recorder.record(std::chrono::steady_clock::now() - t0);
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    recorder.report();
+    return recorder.snapshot();
+}
+
+int main() {
+    const int threads = 4;
+    std::cout << "--- Benchmark harness (" << threads << " threads) ---" << std::endl;
+    std::mutex m;
+    long counter = 0;
+    std::atomic<long> atomic_counter{0};
+    HdrHistogram mutex_hist = benchmark("mutex increment", threads, 200'000, [&] {
+        std::lock_guard<std::mutex> lock(m);
+        ++counter;
+    });
+    HdrHistogram atomic_hist = benchmark("atomic fetch_add", threads, 200'000, [&] {
+        atomic_counter.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::cout << "\n--- ThreadSafeQueue: time items spend in the queue ---" << std::endl;
+    LatencyRecorder queue_wait("queue: wait in queue");
+    ThreadSafeQueue<int> queue(100, &queue_wait);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&] { while (queue.pop()) { /* Consume */ } });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; ++p) {
+        producers.emplace_back([&] { for (int i = 0; i < 100'000; ++i) queue.push(i); });
+    }
+    for (std::thread& p : producers) p.join();
+    queue.set_finished();
+    for (std::thread& c : consumers) c.join();
+    queue_wait.report();
+
+    std::cout << "\n--- SimpleThreadPool: queueing delay and run time ---" << std::endl;
+    {
+        SimpleThreadPool pool(threads);
+        for (int i = 0; i < 20'000; ++i) {
+            pool.enqueue([i] {
+                volatile double x = 0;
+                for (int k = 0; k < (i % 100 == 0 ? 20'000 : 200); ++k) x = x + std::sqrt(static_cast<double>(k)); // 1% slow tasks
+            });
+        }
+        // A task counts as done only after run_time.record() on its worker, so join before reporting
+        pool.shutdown();
+        pool.queue_delay.report();
+        pool.run_time.report();
+    }
+
+    std::cout << "\n--- Serialization and merging ---" << std::endl;
+    std::string wire = mutex_hist.serialize();
+    HdrHistogram restored = HdrHistogram::deserialize(wire);
+    std::cout << "Serialized mutex histogram: " << wire.size() << " bytes, round trip "
+              << (restored.count() == mutex_hist.count() && restored.percentile(99.9) == mutex_hist.percentile(99.9) ? "OK" : "MISMATCH")
+              << std::endl;
+    restored.add(atomic_hist);
+    LatencyRecorder::print_report(std::cout, "merged mutex + atomic", restored);
+    return 0;
+}
+// Compile with: g++ 19_hdr_histogram.cpp -o bin/hdr_histogram -pthread -std=c++17 -O2
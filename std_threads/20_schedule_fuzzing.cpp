@@ -0,0 +1,482 @@
+// Deterministic Schedule Fuzzing + Linearizability Checking
+// Concept: The race in 02_race_condition.cpp only shows up when the OS happens to preempt a thread at the wrong
+// instruction. A schedule fuzzer takes the OS out of the picture:
+//   - Code under test marks interesting points with STRESS_YIELD() (between a load and a store, around a CAS...).
+//   - A seeded scheduler runs the test threads ONE AT A TIME and, at every yield point, picks the next thread with
+//     its own RNG. The interleaving is therefore a pure function of the seed: a failing seed replays exactly.
+//   - Blocking primitives are swapped for fuzz::Mutex / fuzz::CondVar, which yield to the scheduler instead of
+//     sleeping in the kernel (otherwise one blocked thread would stall the single-runner schedule).
+//   - Every operation is logged with invoke/response timestamps and the history is checked for linearizability
+//     against a sequential model (queue, stack, map, counter) with a Wing & Gong style backtracking search.
+// Limitation: only sequentially consistent interleavings at yield points are explored - weak-memory reorderings
+// inside a single atomic operation are not.
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <optional>
+#include <random>
+#include <exception>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace fuzz {
+
+thread_local int current_thread = -1; // Logical thread id inside a fuzzed run, -1 outside
+
+struct Aborted {}; // Thrown from aborting yield points when the step budget runs out (deadlock/livelock)
+
+class Scheduler {
+public:
+    explicit Scheduler(uint64_t seed, long max_steps = 200'000) : rng(seed), max_steps(max_steps) {}
+
+    // Runs each body as a logical thread; returns false if the schedule hit the step budget
+    bool run(std::vector<std::function<void()>> bodies) {
+        n = static_cast<int>(bodies.size());
+        finished.assign(n, false);
+        current = pick();
+        active() = this;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < n; ++i) {
+            threads.emplace_back([this, i, &bodies] {
+                current_thread = i;
+                bool skip;
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    cv.wait(lock, [&] { return current == i; });
+                    skip = aborted;
+                }
+                try {
+                    if (!skip) bodies[i]();
+                } catch (const Aborted&) {
+                }
+                finish(i);
+                current_thread = -1;
+            });
+        }
+        for (std::thread& t : threads) t.join();
+        active() = nullptr;
+        return !aborted;
+    }
+
+    // may_abort = false is for scheduling points reached from destructors (Mutex::unlock under a lock_guard):
+    // they switch threads but never throw. After an abort, threads still run one at a time: the thread holding
+    // the turn keeps it until it unwinds out of its body, and a thread handed the turn throws at its next
+    // aborting yield point, so nothing ever runs unscheduled next to another thread.
+    void yield_point(bool may_abort = true) {
+        const int me = current_thread;
+        std::unique_lock<std::mutex> lock(m);
+        if (may_abort && !aborted && ++steps > max_steps) aborted = true;
+        if (!aborted) {
+            current = pick();
+            if (current != me) {
+                cv.notify_all();
+                cv.wait(lock, [&] { return current == me; });
+            }
+        }
+        if (aborted && may_abort && std::uncaught_exceptions() == 0) throw Aborted{}; // Never throw while unwinding
+    }
+
+    static Scheduler*& active() {
+        static Scheduler* instance = nullptr;
+        return instance;
+    }
+
+private:
+    int pick() {
+        std::vector<int> runnable;
+        for (int i = 0; i < n; ++i) {
+            if (!finished[i]) runnable.push_back(i);
+        }
+        if (runnable.empty()) return -1;
+        return runnable[std::uniform_int_distribution<size_t>(0, runnable.size() - 1)(rng)];
+    }
+
+    void finish(int i) {
+        std::lock_guard<std::mutex> lock(m);
+        finished[i] = true;
+        current = pick();
+        cv.notify_all();
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::mt19937_64 rng;
+    long max_steps;
+    long steps = 0;
+    int n = 0;
+    int current = -1;
+    std::vector<bool> finished;
+    bool aborted = false;
+};
+
+inline void yield_point(bool may_abort = true) {
+    if (current_thread >= 0 && Scheduler::active()) Scheduler::active()->yield_point(may_abort);
+}
+
+// Spin-yield mutex: under the fuzzer only one thread runs, so waiting means handing the turn to someone else
+class Mutex {
+public:
+    void lock() {
+        yield_point();
+        while (locked.exchange(true, std::memory_order_acquire)) yield_point();
+    }
+    bool try_lock() { return !locked.exchange(true, std::memory_order_acquire); }
+    void unlock() {
+        locked.store(false, std::memory_order_release);
+        yield_point(false); // Runs from lock_guard destructors (noexcept): must never throw Aborted
+    }
+private:
+    std::atomic<bool> locked{false};
+};
+
+// Condition variable with (legal) spurious wake-ups: release the lock, let others run, re-check the predicate
+class CondVar {
+public:
+    template<typename Lock, typename Pred>
+    void wait(Lock& lock, Pred pred) {
+        while (!pred()) {
+            lock.unlock();
+            yield_point();
+            if (!Scheduler::active()) std::this_thread::yield();
+            lock.lock();
+        }
+    }
+    void notify_one() {}
+    void notify_all() {}
+};
+
+// --- Operation history ---
+
+enum OpKind { PUSH, POP, PUT, GET, INC, READ };
+
+struct Op {
+    int thread;
+    OpKind kind;
+    long arg;
+    long result;
+    long invoke;
+    long response;
+};
+
+class History {
+public:
+    template<typename F>
+    long record(OpKind kind, long arg, F f) {
+        long invoke = clock.fetch_add(1);
+        yield_point();
+        long result = f();
+        long response = clock.fetch_add(1);
+        std::lock_guard<std::mutex> lock(m);
+        ops.push_back({current_thread, kind, arg, result, invoke, response});
+        return result;
+    }
+
+    std::vector<Op> ops;
+
+private:
+    std::atomic<long> clock{0};
+    std::mutex m;
+};
+
+std::string to_string(const std::vector<Op>& ops) {
+    static const char* names[] = {"push", "pop", "put", "get", "inc", "read"};
+    std::ostringstream out;
+    std::vector<Op> sorted = ops;
+    std::sort(sorted.begin(), sorted.end(), [](const Op& a, const Op& b) { return a.invoke < b.invoke; });
+    for (const Op& op : sorted) {
+        out << "    [" << op.invoke << "," << op.response << "] "
+            << (op.thread < 0 ? std::string("main") : "T" + std::to_string(op.thread)) << " " << names[op.kind]
+            << "(" << op.arg << ") -> " << op.result << "\n";
+    }
+    return out.str();
+}
+
+// --- Linearizability check: is there a total order, consistent with real-time order, that the model accepts? ---
+template<typename Model>
+bool linearizable(const std::vector<Op>& ops) {
+    const size_t n = ops.size();
+    if (n > 64) throw std::invalid_argument("history too long for the bitmask search");
+    const uint64_t all = n == 64 ? ~0ULL : (1ULL << n) - 1;
+    std::set<std::pair<uint64_t, std::string>> failed; // Memo: (ops already linearized, model state)
+
+    std::function<bool(uint64_t, const Model&)> search = [&](uint64_t done, const Model& model) {
+        if (done == all) return true;
+        if (failed.count({done, model.key()})) return false;
+        long min_response = LONG_MAX;
+        for (size_t i = 0; i < n; ++i) {
+            if (!(done >> i & 1)) min_response = std::min(min_response, ops[i].response);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            // Candidate to go next: pending, and not invoked after some other pending op already returned
+            if ((done >> i & 1) || ops[i].invoke > min_response) continue;
+            Model next = model;
+            if (next.apply(ops[i]) && search(done | (1ULL << i), next)) return true;
+        }
+        failed.insert({done, model.key()});
+        return false;
+    };
+    return search(0, Model{});
+}
+
+} // namespace fuzz
+
+#define STRESS_YIELD() fuzz::yield_point()
+
+// --- Sequential models ---
+
+struct QueueModel {
+    std::deque<long> items;
+    bool apply(const fuzz::Op& op) {
+        if (op.kind == fuzz::PUSH) { items.push_back(op.arg); return true; }
+        long expected = items.empty() ? -1 : items.front();
+        if (!items.empty()) items.pop_front();
+        return op.result == expected;
+    }
+    std::string key() const { std::string k; for (long v : items) k += std::to_string(v) + ','; return k; }
+};
+
+struct StackModel {
+    std::vector<long> items;
+    bool apply(const fuzz::Op& op) {
+        if (op.kind == fuzz::PUSH) { items.push_back(op.arg); return true; }
+        long expected = items.empty() ? -1 : items.back();
+        if (!items.empty()) items.pop_back();
+        return op.result == expected;
+    }
+    std::string key() const { std::string k; for (long v : items) k += std::to_string(v) + ','; return k; }
+};
+
+struct MapModel {
+    std::map<long, long> kv;
+    bool apply(const fuzz::Op& op) { // PUT arg = key * 1000 + value, returns the previous value or -1
+        long key = op.kind == fuzz::PUT ? op.arg / 1000 : op.arg;
+        auto it = kv.find(key);
+        long expected = it == kv.end() ? -1 : it->second;
+        if (op.kind == fuzz::PUT) kv[key] = op.arg % 1000;
+        return op.result == expected;
+    }
+    std::string key() const { std::string k; for (auto& [a, b] : kv) k += std::to_string(a) + '=' + std::to_string(b) + ','; return k; }
+};
+
+struct CounterModel {
+    long value = 0;
+    bool apply(const fuzz::Op& op) {
+        if (op.kind == fuzz::INC) { ++value; return true; }
+        return op.result == value;
+    }
+    std::string key() const { return std::to_string(value); }
+};
+
+// --- Containers under test (instrumented with STRESS_YIELD and fuzz sync primitives) ---
+
+// ThreadSafeQueue from 06_task_queue.cpp
+template<typename T>
+class ThreadSafeQueue {
+private:
+    std::queue<T> q;
+    mutable fuzz::Mutex mtx;
+    fuzz::CondVar cv_consumer;
+    fuzz::CondVar cv_producer;
+    size_t max_size;
+    std::atomic<bool> finished = false;
+
+public:
+    ThreadSafeQueue(size_t maxSize = 1000) : max_size(maxSize) {}
+
+    void push(T item) {
+        std::unique_lock<fuzz::Mutex> lock(mtx);
+        cv_producer.wait(lock, [this]{ return q.size() < max_size || finished; });
+        if (finished) return;
+        q.push(std::move(item));
+        lock.unlock();
+        cv_consumer.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<fuzz::Mutex> lock(mtx);
+        cv_consumer.wait(lock, [this]{ return !q.empty() || finished; });
+        if (q.empty()) return std::nullopt;
+        T item = std::move(q.front());
+        q.pop();
+        lock.unlock();
+        cv_producer.notify_one();
+        return item;
+    }
+};
+
+// Treiber stack; RACY = true replaces the CAS with a load/store pair (lost pushes)
+template<bool RACY>
+class TreiberStack {
+    struct Node { long value; Node* next; };
+public:
+    ~TreiberStack() {
+        for (Node* n : all_nodes) delete n; // Nodes are never reused during a run, so there is no ABA
+    }
+    void push(long v) {
+        Node* node = new Node{v, nullptr};
+        { std::lock_guard<std::mutex> lock(nodes_mutex); all_nodes.push_back(node); }
+        while (true) {
+            Node* top = head.load();
+            node->next = top;
+            STRESS_YIELD();
+            if (RACY) { head.store(node); return; }
+            if (head.compare_exchange_strong(top, node)) return;
+        }
+    }
+    long pop() {
+        while (true) {
+            Node* top = head.load();
+            if (!top) return -1;
+            STRESS_YIELD();
+            if (RACY) { head.store(top->next); return top->value; }
+            if (head.compare_exchange_strong(top, top->next)) return top->value;
+        }
+    }
+private:
+    std::atomic<Node*> head{nullptr};
+    std::mutex nodes_mutex;
+    std::vector<Node*> all_nodes;
+};
+
+// Lock-striped hash map
+class StripedMap {
+public:
+    long put(long key, long value) {
+        Stripe& s = stripes[key % STRIPES];
+        std::lock_guard<fuzz::Mutex> lock(s.m);
+        auto it = s.kv.find(key);
+        long old = it == s.kv.end() ? -1 : it->second;
+        STRESS_YIELD();
+        s.kv[key] = value;
+        return old;
+    }
+    long get(long key) {
+        Stripe& s = stripes[key % STRIPES];
+        std::lock_guard<fuzz::Mutex> lock(s.m);
+        auto it = s.kv.find(key);
+        return it == s.kv.end() ? -1 : it->second;
+    }
+private:
+    static constexpr int STRIPES = 4;
+    struct Stripe { fuzz::Mutex m; std::unordered_map<long, long> kv; };
+    Stripe stripes[STRIPES];
+};
+
+// The unsynchronized counter from 02_race_condition.cpp, with a yield between its load and store
+class RacyCounter {
+public:
+    void increment() {
+        long v = counter;
+        STRESS_YIELD();
+        counter = v + 1;
+    }
+    long read() const { return counter; }
+private:
+    long counter = 0;
+};
+
+// --- Test scenarios: each returns the recorded history for one seed ---
+
+struct RunResult {
+    bool completed;
+    std::vector<fuzz::Op> ops;
+};
+
+RunResult run_queue(uint64_t seed) {
+    ThreadSafeQueue<long> q(2); // Tiny bound so producers block too
+    fuzz::History h;
+    fuzz::Scheduler s(seed);
+    auto producer = [&](long base) { return [&, base] { for (long i = 0; i < 3; ++i) h.record(fuzz::PUSH, base + i, [&] { q.push(base + i); return 0L; }); }; };
+    auto consumer = [&] { for (int i = 0; i < 3; ++i) h.record(fuzz::POP, 0, [&] { return q.pop().value_or(-1); }); };
+    bool ok = s.run({producer(10), producer(20), consumer, consumer});
+    return {ok, h.ops};
+}
+
+template<bool RACY>
+RunResult run_stack(uint64_t seed) {
+    TreiberStack<RACY> st;
+    fuzz::History h;
+    fuzz::Scheduler s(seed);
+    auto worker = [&](long base) {
+        return [&, base] {
+            for (long i = 0; i < 2; ++i) h.record(fuzz::PUSH, base + i, [&] { st.push(base + i); return 0L; });
+            for (long i = 0; i < 2; ++i) h.record(fuzz::POP, 0, [&] { return st.pop(); });
+        };
+    };
+    bool ok = s.run({worker(10), worker(20), worker(30)});
+    return {ok, h.ops};
+}
+
+RunResult run_map(uint64_t seed) {
+    StripedMap map;
+    fuzz::History h;
+    fuzz::Scheduler s(seed);
+    auto worker = [&](long id) {
+        return [&, id] {
+            for (long k = 0; k < 3; ++k) {
+                h.record(fuzz::PUT, k * 1000 + id, [&] { return map.put(k, id); });
+                h.record(fuzz::GET, k, [&] { return map.get(k); });
+            }
+        };
+    };
+    bool ok = s.run({worker(1), worker(2), worker(3)});
+    return {ok, h.ops};
+}
+
+RunResult run_counter(uint64_t seed) {
+    RacyCounter c;
+    fuzz::History h;
+    fuzz::Scheduler s(seed);
+    auto worker = [&] {
+        for (int i = 0; i < 2; ++i) h.record(fuzz::INC, 0, [&] { c.increment(); return 0L; });
+    };
+    bool ok = s.run({worker, worker, worker});
+    h.record(fuzz::READ, 0, [&] { return c.read(); }); // After all threads joined: must see 6
+    return {ok, h.ops};
+}
+
+template<typename Model>
+void explore(const std::string& name, RunResult (*scenario)(uint64_t), int schedules) {
+    for (uint64_t seed = 1; seed <= static_cast<uint64_t>(schedules); ++seed) {
+        RunResult r = scenario(seed);
+        if (!r.completed) {
+            std::cout << name << ": seed " << seed << " exhausted the step budget (deadlock/livelock)" << std::endl;
+            return;
+        }
+        if (!fuzz::linearizable<Model>(r.ops)) {
+            std::cout << name << ": NOT linearizable at seed " << seed << "\n"
+                      << fuzz::to_string(r.ops);
+            // Reproducibility: the same seed must yield the same interleaving and the same history
+            RunResult replay = scenario(seed);
+            bool same = fuzz::to_string(replay.ops) == fuzz::to_string(r.ops);
+            std::cout << "  replay of seed " << seed << ": " << (same ? "identical history" : "DIFFERENT history") << std::endl;
+            return;
+        }
+    }
+    std::cout << name << ": " << schedules << " schedules, all linearizable" << std::endl;
+}
+
+int main() {
+    const int schedules = 300;
+    explore<QueueModel>("ThreadSafeQueue", run_queue, schedules);
+    explore<StackModel>("TreiberStack (CAS)", run_stack<false>, schedules);
+    explore<MapModel>("StripedMap", run_map, schedules);
+    explore<StackModel>("TreiberStack (racy store)", run_stack<true>, schedules);
+    explore<CounterModel>("RacyCounter (02_race_condition)", run_counter, schedules);
+    return 0;
+}
+// Compile with: g++ 20_schedule_fuzzing.cpp -o bin/schedule_fuzzing -pthread -std=c++17 -O2
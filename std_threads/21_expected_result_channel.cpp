@@ -0,0 +1,349 @@
+// Allocation-Free Error Transport: Expected<T, E> Result Slots for Pool Tasks
+// Concept: 12_promise_future_exception.cpp and the pool's packaged_task allocate a shared state per task, and every
+// failure goes through throw -> std::exception_ptr (which allocates the exception object, and unwinding is slow).
+// For high-rate tasks that fail routinely (validation rejects) the error is not exceptional - it is a value.
+//   - Expected<T, E> carries either the result or an error code inline (no heap, no exception).
+//   - ResultSlot<T, E> is a pre-allocated, reusable landing spot for one task's Expected, with a ready flag.
+//   - The pool stores tasks in a fixed-capacity ring of InlineTask objects (small-buffer callables), so neither
+//     enqueuing nor completing a task touches the allocator on the success OR the error path.
+// Benchmark: packaged_task + throw, promise + set_exception, and Expected slots, at several failure rates.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <variant>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+// --- Global allocation counter ---
+std::atomic<long> allocation_count{0};
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// --- Expected<T, E> (a minimal C++17 stand-in for C++23 std::expected) ---
+template<typename E>
+struct Unexpected {
+    E error;
+};
+
+template<typename E>
+Unexpected<E> unexpected(E e) { return {e}; }
+
+template<typename T, typename E>
+class Expected {
+public:
+    Expected(T value) : storage(std::in_place_index<0>, std::move(value)) {}
+    Expected(Unexpected<E> u) : storage(std::in_place_index<1>, u.error) {}
+
+    bool has_value() const { return storage.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+    const T& value() const { return std::get<0>(storage); }
+    E error() const { return std::get<1>(storage); }
+
+private:
+    std::variant<T, E> storage; // Inline: sizeof(Expected) ~ max(sizeof(T), sizeof(E)) + tag
+};
+
+enum class ErrorCode { None, ValidationRejected, OutOfRange };
+
+const char* to_string(ErrorCode e) {
+    switch (e) {
+        case ErrorCode::ValidationRejected: return "ValidationRejected";
+        case ErrorCode::OutOfRange: return "OutOfRange";
+        default: return "None";
+    }
+}
+
+// Reusable, pre-allocated result landing spot
+template<typename T, typename E>
+class ResultSlot {
+public:
+    void set(Expected<T, E>&& r) {
+        result.emplace(std::move(r));
+        ready.store(true, std::memory_order_release);
+    }
+
+    const Expected<T, E>& wait() const {
+        while (!ready.load(std::memory_order_acquire)) std::this_thread::yield();
+        return *result;
+    }
+
+    void reset() {
+        ready.store(false, std::memory_order_relaxed);
+        result.reset();
+    }
+
+private:
+    std::optional<Expected<T, E>> result;
+    std::atomic<bool> ready{false};
+};
+
+// Type-erased callable stored in a fixed inline buffer: move-only captures are fine, heap use is impossible
+class InlineTask {
+public:
+    static constexpr size_t CAPACITY = 48;
+
+    InlineTask() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineTask>>>
+    InlineTask(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= CAPACITY, "task captures too large for InlineTask");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "task captures over-aligned for InlineTask storage");
+        new (storage) Fn(std::forward<F>(f));
+        ops = &ops_for<Fn>;
+    }
+
+    InlineTask(InlineTask&& other) noexcept { move_from(other); }
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) { destroy(); move_from(other); }
+        return *this;
+    }
+    ~InlineTask() { destroy(); }
+
+    void operator()() { ops->invoke(storage); }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template<typename Fn>
+    static constexpr Ops ops_for = {
+        [](void* p) { (*static_cast<Fn*>(p))(); },
+        [](void* dst, void* src) { new (dst) Fn(std::move(*static_cast<Fn*>(src))); },
+        [](void* p) { static_cast<Fn*>(p)->~Fn(); },
+    };
+
+    void move_from(InlineTask& other) {
+        ops = other.ops;
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.destroy();
+        }
+    }
+    void destroy() {
+        if (ops) { ops->destroy(storage); ops = nullptr; }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[CAPACITY];
+    const Ops* ops = nullptr;
+};
+
+// SimpleThreadPool (14_simple_threadpool.cpp) with a bounded ring of InlineTask instead of queue<function>
+class SimpleThreadPool {
+public:
+    SimpleThreadPool(size_t numThreads, size_t capacity = 1024) : tasks(capacity), stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    InlineTask task;
+                    {
+                        std::unique_lock<std::mutex> lock(this->queue_mutex);
+                        this->not_empty.wait(lock, [this] { return this->stop || count > 0; });
+                        if (this->stop && count == 0) return;
+                        task = std::move(tasks[head]);
+                        head = (head + 1) % tasks.size();
+                        --count;
+                    }
+                    not_full.notify_one();
+                    task();
+                }
+            });
+        }
+    }
+
+    template<typename F>
+    void enqueue(F&& f) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            not_full.wait(lock, [this] { return stop || count < tasks.size(); });
+            if (stop) throw std::runtime_error("Enqueue on stopped ThreadPool");
+            tasks[(head + count) % tasks.size()] = InlineTask(std::forward<F>(f));
+            ++count;
+        }
+        not_empty.notify_one();
+    }
+
+    // Original API: shared packaged_task + future, failures travel as exceptions
+    template<class F>
+    auto enqueue_task(F&& f) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto task_ptr = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> res = task_ptr->get_future();
+        enqueue([task_ptr] { (*task_ptr)(); });
+        return res;
+    }
+
+    // New API: the task returns Expected<T, E>, which is written straight into the caller's slot
+    template<typename T, typename E, typename F>
+    void enqueue_expected(ResultSlot<T, E>& slot, F&& f) {
+        enqueue([&slot, fn = std::forward<F>(f)]() mutable { slot.set(fn()); });
+    }
+
+    ~SimpleThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<InlineTask> tasks; // Ring buffer, allocated once
+    size_t head = 0, count = 0;
+    std::mutex queue_mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    bool stop;
+};
+
+// --- Workload: validate an input, rejecting fail_pct percent of them ---
+
+bool rejected(int x, int fail_pct) { return x % 100 < fail_pct; }
+
+long validate_or_throw(int x, int fail_pct) {
+    if (rejected(x, fail_pct)) throw std::invalid_argument("input rejected by validation");
+    return static_cast<long>(x) * x;
+}
+
+Expected<long, ErrorCode> validate(int x, int fail_pct) {
+    if (rejected(x, fail_pct)) return unexpected(ErrorCode::ValidationRejected);
+    return static_cast<long>(x) * x;
+}
+
+struct Measurement {
+    double ns_per_task;
+    double allocs_per_task;
+    long failures;
+};
+
+constexpr int BATCH = 512;
+
+Measurement bench_packaged_task(SimpleThreadPool& pool, int tasks, int fail_pct) {
+    long failures = 0;
+    std::vector<std::future<long>> futures;
+    futures.reserve(BATCH);
+    long allocs = allocation_count.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int base = 0; base < tasks; base += BATCH) {
+        futures.clear();
+        for (int i = 0; i < BATCH; ++i) {
+            int x = base + i;
+            futures.push_back(pool.enqueue_task([x, fail_pct] { return validate_or_throw(x, fail_pct); }));
+        }
+        for (auto& f : futures) {
+            try { f.get(); } catch (const std::invalid_argument&) { ++failures; }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count() / tasks,
+            static_cast<double>(allocation_count.load() - allocs) / tasks, failures};
+}
+
+Measurement bench_promise(SimpleThreadPool& pool, int tasks, int fail_pct) {
+    long failures = 0;
+    std::vector<std::future<long>> futures;
+    futures.reserve(BATCH);
+    long allocs = allocation_count.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int base = 0; base < tasks; base += BATCH) {
+        futures.clear();
+        for (int i = 0; i < BATCH; ++i) {
+            int x = base + i;
+            std::promise<long> p;
+            futures.push_back(p.get_future());
+            pool.enqueue([p = std::move(p), x, fail_pct]() mutable { // Move-only capture: fine in InlineTask
+                if (rejected(x, fail_pct)) {
+                    p.set_exception(std::make_exception_ptr(std::invalid_argument("input rejected by validation")));
+                } else {
+                    p.set_value(static_cast<long>(x) * x);
+                }
+            });
+        }
+        for (auto& f : futures) {
+            try { f.get(); } catch (const std::invalid_argument&) { ++failures; }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count() / tasks,
+            static_cast<double>(allocation_count.load() - allocs) / tasks, failures};
+}
+
+Measurement bench_expected(SimpleThreadPool& pool, std::vector<ResultSlot<long, ErrorCode>>& slots, int tasks, int fail_pct) {
+    long failures = 0;
+    long allocs = allocation_count.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int base = 0; base < tasks; base += BATCH) {
+        for (int i = 0; i < BATCH; ++i) {
+            int x = base + i;
+            slots[i].reset();
+            pool.enqueue_expected(slots[i], [x, fail_pct] { return validate(x, fail_pct); });
+        }
+        for (auto& s : slots) {
+            const Expected<long, ErrorCode>& r = s.wait();
+            if (!r) ++failures;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count() / tasks,
+            static_cast<double>(allocation_count.load() - allocs) / tasks, failures};
+}
+
+int main() {
+    SimpleThreadPool pool(4);
+    std::vector<ResultSlot<long, ErrorCode>> slots(BATCH); // Allocated once, reused by every batch
+    const int tasks = 100 * BATCH;
+
+    // Example usage
+    pool.enqueue_expected(slots[0], [] { return validate(7, 50); });
+    pool.enqueue_expected(slots[1], [] { return validate(77, 50); });
+    for (int i = 0; i < 2; ++i) {
+        const auto& r = slots[i].wait();
+        if (r) std::cout << "Task " << i << ": value " << r.value() << std::endl;
+        else std::cout << "Task " << i << ": error " << to_string(r.error()) << std::endl;
+    }
+
+    std::cout << "\n" << tasks << " tasks per run, 4 workers" << std::endl;
+    std::cout << "fail%   channel                      ns/task   allocs/task" << std::endl;
+    for (int fail_pct : {0, 10, 50, 90}) {
+        Measurement pt = bench_packaged_task(pool, tasks, fail_pct);
+        Measurement pr = bench_promise(pool, tasks, fail_pct);
+        Measurement ex = bench_expected(pool, slots, tasks, fail_pct);
+        auto row = [&](const char* name, const Measurement& m) {
+            std::cout << std::setw(4) << fail_pct << "    " << std::left << std::setw(28) << name << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(8) << m.ns_per_task
+                      << std::setw(12) << std::setprecision(2) << m.allocs_per_task << std::endl;
+        };
+        row("packaged_task + throw", pt);
+        row("promise + set_exception", pr);
+        row("Expected + ResultSlot", ex);
+        if (pt.failures != ex.failures || pr.failures != ex.failures) std::cout << "    FAILURE COUNTS DIFFER" << std::endl;
+    }
+    return 0;
+}
+// Compile with: g++ 21_expected_result_channel.cpp -o bin/expected_result_channel -pthread -std=c++17 -O2
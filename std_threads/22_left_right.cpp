@@ -0,0 +1,261 @@
+// Left-Right: Wait-Free Reads Without Garbage Collection
+// Concept: 09_shared_mutex_shared_lock.cpp lets many readers share a std::map, but every reader still writes the
+// shared_mutex's reader count (one contended cache line) and can be blocked by a writer. Left-Right keeps TWO
+// copies of the data structure instead:
+//   readers: announce themselves on a per-thread read indicator -> read the ACTIVE copy -> depart.
+//            No loop, no lock, no retry: wait-free, and never blocked by the writer.
+//   writer:  apply the mutation to the INACTIVE copy -> flip readers over to it -> wait until no reader can still
+//            be on the old copy -> apply the same mutation to the old copy.
+// Both copies are always complete data structures, so nothing is ever freed while a reader might hold it:
+// no hazard pointers, no epochs, no shared_ptr reference counts. The cost is 2x memory and every mutation runs
+// twice (so it must be deterministic), and writers are serialized by a mutex.
+// Benchmarked against std::shared_mutex and an RCU-style copy-on-write snapshot (atomic shared_ptr swap).
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+// Per-thread read indicator: a thread arrives/departs on its own cache line, so readers never contend with each
+// other. Threads beyond SLOTS share slots (still correct - counters are atomic - just less scalable).
+class ReadIndicator {
+public:
+    static constexpr int SLOTS = 64;
+
+    void arrive(int slot) { counters_[slot].count.fetch_add(1, std::memory_order_seq_cst); }
+    void depart(int slot) { counters_[slot].count.fetch_sub(1, std::memory_order_release); }
+
+    bool is_empty() const {
+        for (const auto& c : counters_) {
+            if (c.count.load(std::memory_order_acquire) != 0) return false;
+        }
+        return true;
+    }
+
+private:
+    struct alignas(64) PaddedCounter {
+        std::atomic<long> count{0};
+    };
+    PaddedCounter counters_[SLOTS];
+};
+
+// Small stable per-thread id used to pick a read-indicator slot
+inline int thread_slot() {
+    static std::atomic<int> next_slot{0};
+    thread_local int slot = next_slot.fetch_add(1, std::memory_order_relaxed) % ReadIndicator::SLOTS;
+    return slot;
+}
+
+template<typename T>
+class LeftRight {
+public:
+    template<typename... Args>
+    explicit LeftRight(const Args&... args) : instances_{T(args...), T(args...)} {}
+
+    LeftRight(const LeftRight&) = delete;
+    LeftRight& operator=(const LeftRight&) = delete;
+
+    // Wait-free read: fn receives a const reference valid only for the duration of the call
+    template<typename F>
+    auto read(F&& fn) const {
+        const int slot = thread_slot();
+        const int vi = version_index_.load(std::memory_order_seq_cst);
+        indicators_[vi].arrive(slot);
+        const T& instance = instances_[left_right_.load(std::memory_order_seq_cst)];
+        struct Departer {
+            ReadIndicator& indicator;
+            int slot;
+            ~Departer() { indicator.depart(slot); }
+        } departer{indicators_[vi], slot};
+        return fn(instance);
+    }
+
+    // Blocking write: fn(T&) is applied to both copies in turn, so it must produce the same result each time
+    template<typename F>
+    void modify(F&& fn) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        const int lr = left_right_.load(std::memory_order_relaxed);
+        fn(instances_[1 - lr]);                                  // 1. Update the copy no reader can see
+        left_right_.store(1 - lr, std::memory_order_seq_cst);    // 2. New readers go to the updated copy
+        toggle_version_and_wait();                               // 3. Wait out readers still on the old copy
+        fn(instances_[lr]);                                      // 4. Bring the old copy up to date
+    }
+
+private:
+    // Readers that arrived on the current version index may have read left_right_ before the flip. Move new
+    // arrivals to the other indicator, then wait for both indicators to drain in order; after that no reader can
+    // be inside the old copy.
+    void toggle_version_and_wait() {
+        const int prev = version_index_.load(std::memory_order_relaxed);
+        const int next = 1 - prev;
+        while (!indicators_[next].is_empty()) std::this_thread::yield();
+        version_index_.store(next, std::memory_order_seq_cst);
+        while (!indicators_[prev].is_empty()) std::this_thread::yield();
+    }
+
+    T instances_[2];
+    alignas(64) std::atomic<int> left_right_{0};    // Which copy readers use
+    alignas(64) std::atomic<int> version_index_{0}; // Which read indicator new readers arrive on
+    mutable ReadIndicator indicators_[2];
+    std::mutex writer_mutex_;
+};
+
+// --- The same lookup table behind the three strategies ---
+
+using Table = std::map<int, int>;
+
+class SharedMutexTable {
+public:
+    explicit SharedMutexTable(const Table& init) : table_(init) {}
+    bool lookup(int key, int& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = table_.find(key);
+        if (it == table_.end()) return false;
+        value = it->second;
+        return true;
+    }
+    void update(int key, int value) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        table_[key] = value;
+    }
+private:
+    mutable std::shared_mutex mutex_;
+    Table table_;
+};
+
+// RCU-style: readers grab the current immutable snapshot; the writer copies the whole map, edits the copy and
+// publishes it. Old snapshots are freed by the last shared_ptr owner. std::atomic_load on shared_ptr is
+// lock-based in libstdc++ (a small spinlock pool), and every update copies O(n) nodes.
+class SnapshotTable {
+public:
+    explicit SnapshotTable(const Table& init) : snapshot_(std::make_shared<const Table>(init)) {}
+    bool lookup(int key, int& value) const {
+        std::shared_ptr<const Table> snap = std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+        auto it = snap->find(key);
+        if (it == snap->end()) return false;
+        value = it->second;
+        return true;
+    }
+    void update(int key, int value) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        auto next = std::make_shared<Table>(*snapshot_);
+        (*next)[key] = value;
+        std::atomic_store_explicit(&snapshot_, std::shared_ptr<const Table>(std::move(next)), std::memory_order_release);
+    }
+private:
+    std::shared_ptr<const Table> snapshot_;
+    std::mutex writer_mutex_;
+};
+
+class LeftRightTable {
+public:
+    explicit LeftRightTable(const Table& init) : lr_(init) {}
+    bool lookup(int key, int& value) const {
+        return lr_.read([&](const Table& t) {
+            auto it = t.find(key);
+            if (it == t.end()) return false;
+            value = it->second;
+            return true;
+        });
+    }
+    void update(int key, int value) {
+        lr_.modify([=](Table& t) { t[key] = value; });
+    }
+private:
+    LeftRight<Table> lr_;
+};
+
+struct BenchResult {
+    double reads_per_sec;
+    double writes_per_sec;
+    bool consistent;
+};
+
+// Readers hammer lookups while one writer updates at full speed (or paced). Every value written is key * 7 + k,
+// so a reader can check it never sees a torn or foreign value.
+template<typename TableT>
+BenchResult run_bench(const Table& init, int readers, std::chrono::milliseconds duration, int write_pause_us) {
+    TableT table(init);
+    const int keys = static_cast<int>(init.size());
+    std::atomic<bool> stop{false};
+    std::atomic<long> total_reads{0};
+    std::atomic<bool> consistent{true};
+    long writes = 0;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::mt19937 rng(r + 1);
+            std::uniform_int_distribution<int> pick(0, keys - 1);
+            long reads = 0;
+            bool ok = true;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    int key = pick(rng), value = 0;
+                    if (!table.lookup(key, value) || (value - key * 7) % 1000 != 0) ok = false;
+                }
+                reads += 256;
+            }
+            total_reads += reads;
+            if (!ok) consistent = false;
+        });
+    }
+    threads.emplace_back([&] {
+        std::mt19937 rng(12345);
+        std::uniform_int_distribution<int> pick(0, keys - 1);
+        while (!stop.load(std::memory_order_relaxed)) {
+            int key = pick(rng);
+            table.update(key, key * 7 + 1000 * static_cast<int>(writes % 1000));
+            ++writes;
+            if (write_pause_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(write_pause_us));
+        }
+    });
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    double secs = std::chrono::duration<double>(duration).count();
+    return {total_reads / secs, writes / secs, consistent.load()};
+}
+
+int main() {
+    std::cout << "--- Left-Right vs shared_mutex vs RCU-style snapshot ---" << std::endl;
+    const int KEYS = 10000;
+    Table init;
+    for (int k = 0; k < KEYS; ++k) init[k] = k * 7;
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const auto duration = std::chrono::milliseconds(300);
+    std::cout << "Hardware threads: " << hw << ", keys: " << KEYS << std::endl;
+
+    for (int write_pause_us : {0, 100}) {
+        std::cout << "\nWriter " << (write_pause_us ? "paced (one update / 100us)" : "unpaced (updates back-to-back)") << std::endl;
+        std::cout << "Readers  strategy        Mreads/s   writes/s   consistent" << std::endl;
+        std::vector<int> reader_counts = {1, 2, 4};
+        if (hw > 4) reader_counts.push_back(static_cast<int>(hw));
+        for (int readers : reader_counts) {
+            auto print = [&](const char* name, const BenchResult& r) {
+                std::cout << std::setw(7) << readers << "  " << std::left << std::setw(14) << name << std::right
+                          << std::fixed << std::setprecision(2) << std::setw(10) << r.reads_per_sec / 1e6
+                          << std::setprecision(0) << std::setw(11) << r.writes_per_sec
+                          << "   " << (r.consistent ? "Yes" : "No") << std::endl;
+            };
+            print("shared_mutex", run_bench<SharedMutexTable>(init, readers, duration, write_pause_us));
+            print("snapshot(RCU)", run_bench<SnapshotTable>(init, readers, duration, write_pause_us));
+            print("left-right", run_bench<LeftRightTable>(init, readers, duration, write_pause_us));
+        }
+    }
+    std::cout << "\nLeft-right: reads never wait and nothing is reclaimed; updates cost 2x the work plus a reader drain."
+              << "\nSnapshot: reads are cheap but each update copies the whole map." << std::endl;
+    return 0;
+}
+// Compile with: g++ 22_left_right.cpp -o bin/left_right -pthread -std=c++17 -O2
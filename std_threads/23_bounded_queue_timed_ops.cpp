@@ -0,0 +1,382 @@
+// Bounded Blocking Queue with Timed and Non-Blocking Operations
+// Concept: ThreadSafeQueue (06_task_queue.cpp) only has a blocking push()/pop(), always takes the mutex, and after
+// set_finished() push() silently drops the item. Latency-sensitive callers need more control:
+//   try_push / try_pop              never block: Ok, Full, Empty or Closed
+//   push_for / push_until           block at most until a timeout: ... or Timeout
+//   pop_for  / pop_until
+//   push / pop                      block until done or closed
+//   close()                         further pushes FAIL with Closed and hand the item back (nothing is dropped);
+//                                   consumers still drain every item accepted before close, then get Closed.
+// Fast path: the storage is a lock-free bounded ring (Vyukov's per-cell sequence numbers). When the queue is neither
+// full nor empty, push/pop are one CAS and never touch the mutex. The mutex + condition variables are only the
+// slow path for sleeping, and a successful operation only notifies when a waiter count says someone is asleep.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <algorithm>
+#include <cstdint>
+
+enum class QueueStatus { Ok, Full, Empty, Timeout, Closed };
+
+const char* to_string(QueueStatus s) {
+    switch (s) {
+        case QueueStatus::Ok: return "Ok";
+        case QueueStatus::Full: return "Full";
+        case QueueStatus::Empty: return "Empty";
+        case QueueStatus::Timeout: return "Timeout";
+        case QueueStatus::Closed: return "Closed";
+    }
+    return "?";
+}
+
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t min_capacity) {
+        size_t cap = 2;
+        while (cap < min_capacity) cap <<= 1;
+        mask_ = cap - 1;
+        cells_ = std::vector<Cell>(cap);
+        for (size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // --- Non-blocking. The item is only moved from on Ok. ---
+
+    QueueStatus try_push(T&& item) {
+        QueueStatus s = push_fast(item);
+        if (s == QueueStatus::Ok) wake(pop_waiters_, not_empty_);
+        return s;
+    }
+
+    QueueStatus try_pop(T& out) {
+        QueueStatus s = pop_fast(out);
+        if (s == QueueStatus::Ok) wake(push_waiters_, not_full_);
+        return s;
+    }
+
+    // --- Timed ---
+
+    template<typename Rep, typename Period>
+    QueueStatus push_for(T&& item, std::chrono::duration<Rep, Period> timeout) {
+        return push_until(std::move(item), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<typename Clock, typename Duration>
+    QueueStatus push_until(T&& item, std::chrono::time_point<Clock, Duration> deadline) {
+        return blocking_op([&] { return push_fast(item); }, QueueStatus::Full, push_waiters_, not_full_,
+                           pop_waiters_, not_empty_, &deadline);
+    }
+
+    template<typename Rep, typename Period>
+    QueueStatus pop_for(T& out, std::chrono::duration<Rep, Period> timeout) {
+        return pop_until(out, std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<typename Clock, typename Duration>
+    QueueStatus pop_until(T& out, std::chrono::time_point<Clock, Duration> deadline) {
+        return blocking_op([&] { return pop_fast(out); }, QueueStatus::Empty, pop_waiters_, not_empty_,
+                           push_waiters_, not_full_, &deadline);
+    }
+
+    // --- Blocking: wait as long as it takes (or until closed) ---
+
+    QueueStatus push(T&& item) {
+        return blocking_op([&] { return push_fast(item); }, QueueStatus::Full, push_waiters_, not_full_,
+                           pop_waiters_, not_empty_, static_cast<std::chrono::steady_clock::time_point*>(nullptr));
+    }
+
+    std::optional<T> pop() {
+        T out;
+        QueueStatus s = blocking_op([&] { return pop_fast(out); }, QueueStatus::Empty, pop_waiters_, not_empty_,
+                                    push_waiters_, not_full_, static_cast<std::chrono::steady_clock::time_point*>(nullptr));
+        if (s != QueueStatus::Ok) return std::nullopt;
+        return out;
+    }
+
+    // Reject all future pushes. Items already accepted stay poppable; once they are drained pop returns Closed.
+    void close() {
+        enqueue_pos_.fetch_or(CLOSED_BIT, std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(mtx_);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool is_closed() const { return (enqueue_pos_.load(std::memory_order_acquire) & CLOSED_BIT) != 0; }
+
+private:
+    // The closed flag lives in the enqueue position itself: a push either claims a position before close() (and
+    // will be delivered) or sees the bit and fails. No push can slip in after consumers decided the queue is drained.
+    static constexpr uint64_t CLOSED_BIT = uint64_t(1) << 63;
+
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> seq{0};
+        std::optional<T> value;
+    };
+
+    QueueStatus push_fast(T& item) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & CLOSED_BIT) return QueueStatus::Closed;
+            Cell& cell = cells_[pos & mask_];
+            uint64_t seq = cell.seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value.emplace(std::move(item));
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return QueueStatus::Ok;
+                }
+            } else if (diff < 0) {
+                return QueueStatus::Full;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    QueueStatus pop_fast(T& out) {
+        uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            uint64_t seq = cell.seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(*cell.value);
+                    cell.value.reset();
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return QueueStatus::Ok;
+                }
+            } else if (diff < 0) {
+                // Empty - but only Closed once every claimed push position has been consumed; a push that claimed
+                // a slot before close() but has not published yet still has to be delivered.
+                uint64_t enq = enqueue_pos_.load(std::memory_order_acquire);
+                if ((enq & CLOSED_BIT) && (enq & ~CLOSED_BIT) == pos) return QueueStatus::Closed;
+                return QueueStatus::Empty;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Notify only if someone may be sleeping. The seq_cst fence pairs with the one in blocking_op: either the waiter
+    // sees our completed operation when it retries under the mutex, or we see its waiter count and notify.
+    void wake(std::atomic<int>& waiters, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            cv.notify_all();
+        }
+    }
+
+    // Fast path first; otherwise register as a waiter and sleep on cv until op succeeds, the queue closes, or the
+    // deadline passes (deadline == nullptr: no timeout). On success, wake the other side.
+    template<typename Op, typename TimePoint>
+    QueueStatus blocking_op(Op op, QueueStatus would_block, std::atomic<int>& my_waiters, std::condition_variable& my_cv,
+                            std::atomic<int>& other_waiters, std::condition_variable& other_cv, const TimePoint* deadline) {
+        QueueStatus s = op();
+        if (s == would_block) {
+            std::unique_lock<std::mutex> lock(mtx_);
+            my_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while ((s = op()) == would_block) {
+                if (deadline == nullptr) {
+                    my_cv.wait(lock);
+                } else if (my_cv.wait_until(lock, *deadline) == std::cv_status::timeout) {
+                    if ((s = op()) == would_block) s = QueueStatus::Timeout;
+                    break;
+                }
+            }
+            my_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (s == QueueStatus::Ok) wake(other_waiters, other_cv);
+        return s;
+    }
+
+    std::vector<Cell> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+    alignas(64) std::atomic<int> push_waiters_{0};
+    std::atomic<int> pop_waiters_{0};
+    std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+// --- Baseline: the mutex-only queue from 06_task_queue.cpp ---
+template<typename T>
+class ThreadSafeQueue {
+private:
+    std::queue<T> q;
+    mutable std::mutex mtx;
+    std::condition_variable cv_consumer;
+    std::condition_variable cv_producer;
+    size_t max_size;
+    std::atomic<bool> finished = false;
+
+public:
+    ThreadSafeQueue(size_t maxSize = 1000) : max_size(maxSize) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_producer.wait(lock, [this]{ return q.size() < max_size || finished; });
+        if (finished) return;
+        q.push(std::move(item));
+        lock.unlock();
+        cv_consumer.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_consumer.wait(lock, [this]{ return !q.empty() || finished; });
+        if (q.empty()) return std::nullopt;
+        T item = std::move(q.front());
+        q.pop();
+        lock.unlock();
+        cv_producer.notify_one();
+        return item;
+    }
+
+    void set_finished() {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+        cv_consumer.notify_all();
+        cv_producer.notify_all();
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+double ns_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+int main() {
+    std::cout << "--- Bounded Queue: try/timed/close semantics ---" << std::endl;
+    BoundedQueue<int> q(4);
+    int v = 0;
+    std::cout << "try_pop on empty:        " << to_string(q.try_pop(v)) << std::endl;
+    for (int i = 0; i < 4; ++i) q.try_push(int(i));
+    std::cout << "try_push on full:        " << to_string(q.try_push(99)) << std::endl;
+    std::cout << "push_for 2ms on full:    " << to_string(q.push_for(99, std::chrono::milliseconds(2))) << std::endl;
+    q.close();
+    int rejected = 42;
+    std::cout << "push after close:        " << to_string(q.try_push(std::move(rejected)))
+              << " (item handed back: " << rejected << ")" << std::endl;
+    std::cout << "drain after close:      ";
+    while (q.try_pop(v) == QueueStatus::Ok) std::cout << " " << v;
+    std::cout << "\ntry_pop closed+drained:  " << to_string(q.try_pop(v)) << std::endl;
+    std::cout << "pop() closed+drained:    " << (q.pop() ? "value" : "nullopt") << std::endl;
+
+    // --- Timeout precision: pop_for on an empty queue, measure overshoot beyond the requested timeout ---
+    std::cout << "\nTimeout precision (pop_for on empty queue, 20 samples each)" << std::endl;
+    std::cout << "requested      mean actual    max overshoot" << std::endl;
+    BoundedQueue<int> empty(16);
+    for (auto timeout : {std::chrono::microseconds(50), std::chrono::microseconds(500),
+                         std::chrono::microseconds(5000)}) {
+        double sum = 0, worst = 0;
+        const int samples = 20;
+        for (int i = 0; i < samples; ++i) {
+            auto t0 = Clock::now();
+            empty.pop_for(v, timeout);
+            double us = ns_since(t0) / 1e3;
+            sum += us;
+            worst = std::max(worst, us - timeout.count());
+        }
+        std::cout << std::setw(7) << timeout.count() << " us   " << std::fixed << std::setprecision(1)
+                  << std::setw(10) << sum / samples << " us   " << std::setw(10) << worst << " us" << std::endl;
+    }
+
+    // --- Fast-path cost: uncontended push+pop pairs on one thread ---
+    const int OPS = 2'000'000;
+    std::cout << "\nFast-path cost (single thread, push+pop pairs, queue never full/empty at the blocking point)" << std::endl;
+    {
+        BoundedQueue<int> bq(1024);
+        ThreadSafeQueue<int> tq(1024);
+        int out = 0;
+        long sink = 0;
+        auto t0 = Clock::now();
+        for (int i = 0; i < OPS; ++i) { bq.try_push(int(i)); bq.try_pop(out); sink += out; }
+        double bq_ns = ns_since(t0) / OPS;
+        t0 = Clock::now();
+        for (int i = 0; i < OPS; ++i) { bq.push(int(i)); sink += *bq.pop(); }
+        double bq_block_ns = ns_since(t0) / OPS;
+        t0 = Clock::now();
+        for (int i = 0; i < OPS; ++i) { tq.push(i); sink += *tq.pop(); }
+        double tq_ns = ns_since(t0) / OPS;
+        std::cout << "BoundedQueue try_push+try_pop: " << std::setprecision(1) << bq_ns << " ns" << std::endl;
+        std::cout << "BoundedQueue push+pop:         " << bq_block_ns << " ns" << std::endl;
+        std::cout << "ThreadSafeQueue push+pop:      " << tq_ns << " ns   (checksum " << sink % 1000 << ")" << std::endl;
+    }
+
+    // --- Producer/consumer throughput, then close() instead of set_finished() ---
+    std::cout << "\nProducer/consumer throughput (2 producers, 2 consumers, capacity 256)" << std::endl;
+    {
+        const int PER_PRODUCER = 500'000;
+        BoundedQueue<int> bq(256);
+        std::atomic<long> consumed_sum{0}, consumed{0};
+        auto t0 = Clock::now();
+        std::vector<std::thread> threads;
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&] {
+                long local = 0, count = 0;
+                while (auto item = bq.pop()) { local += *item; ++count; }
+                consumed_sum += local;
+                consumed += count;
+            });
+        }
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 2; ++p) {
+            producers.emplace_back([&] {
+                for (int i = 0; i < PER_PRODUCER; ++i) bq.push(int(i));
+            });
+        }
+        for (auto& t : producers) t.join();
+        bq.close();
+        for (auto& t : threads) t.join();
+        double secs = ns_since(t0) / 1e9;
+        long expected_sum = 2L * PER_PRODUCER * (PER_PRODUCER - 1) / 2;
+        std::cout << "BoundedQueue:    " << std::setprecision(2) << consumed / secs / 1e6 << " M items/s, all delivered: "
+                  << (consumed == 2L * PER_PRODUCER && consumed_sum == expected_sum ? "Yes" : "No") << std::endl;
+
+        ThreadSafeQueue<int> tq(256);
+        std::atomic<long> tq_consumed{0};
+        t0 = Clock::now();
+        threads.clear();
+        producers.clear();
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&] {
+                long count = 0;
+                while (tq.pop()) ++count;
+                tq_consumed += count;
+            });
+        }
+        for (int p = 0; p < 2; ++p) {
+            producers.emplace_back([&] {
+                for (int i = 0; i < PER_PRODUCER; ++i) tq.push(i);
+            });
+        }
+        for (auto& t : producers) t.join();
+        tq.set_finished();
+        for (auto& t : threads) t.join();
+        secs = ns_since(t0) / 1e9;
+        std::cout << "ThreadSafeQueue: " << tq_consumed / secs / 1e6 << " M items/s, all delivered: "
+                  << (tq_consumed == 2L * PER_PRODUCER ? "Yes" : "No") << std::endl;
+    }
+    return 0;
+}
+// Compile with: g++ 23_bounded_queue_timed_ops.cpp -o bin/bounded_queue -pthread -std=c++17 -O2
@@ -0,0 +1,277 @@
+// Sharded Multi-Queue Dispatcher
+// Concept: In 06_task_queue.cpp every producer and every consumer locks the same `mtx`, so adding threads adds
+// contention on one cache line and one lock queue. ShardedQueue splits the queue into N independent sub-queues:
+//   producers: push to their HOME shard (thread affinity), so two producers rarely touch the same lock
+//   consumers: pop from their home shard first, then steal round-robin from the others (try_lock only, so a busy
+//              shard is skipped instead of waited on); they sleep on a shared condition variable only when every
+//              shard is empty
+//   keyed mode: push_keyed(key, item) hashes the key to a shard, and each shard is drained by exactly one consumer
+//               with stealing disabled, so items with the same key are processed in push order.
+// Benchmarked against the single-mutex ThreadSafeQueue at 1-64 producers and consumers.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <algorithm>
+
+enum class Ordering { None, PerKey };
+
+template<typename T>
+class ShardedQueue {
+public:
+    // PerKey ordering: one consumer per shard and no stealing, so use as many consumers as shards
+    explicit ShardedQueue(size_t shards, Ordering ordering = Ordering::None)
+        : shards_(shards), ordering_(ordering) {}
+
+    ShardedQueue(const ShardedQueue&) = delete;
+    ShardedQueue& operator=(const ShardedQueue&) = delete;
+
+    size_t shard_count() const { return shards_.size(); }
+
+    // Push to the calling thread's home shard
+    void push(T item) { push_to(home_shard(), std::move(item)); }
+
+    // Push to the shard owning `key`: same key -> same shard -> FIFO relative to each other
+    template<typename Key>
+    void push_keyed(const Key& key, T item) { push_to(std::hash<Key>{}(key) % shards_.size(), std::move(item)); }
+
+    // Pop for consumer `consumer_id`: home shard, then steal (unless PerKey), then sleep.
+    // Returns nullopt once set_finished() was called and every shard is empty.
+    std::optional<T> pop(size_t consumer_id) {
+        const size_t n = shards_.size();
+        const size_t home = consumer_id % n;
+        for (;;) {
+            if (auto item = try_pop_shard(home, /*block_on_lock=*/true)) return item;
+            if (ordering_ == Ordering::None) {
+                for (size_t i = 1; i < n; ++i) {
+                    if (auto item = try_pop_shard((home + i) % n, /*block_on_lock=*/false)) return item;
+                }
+            }
+
+            // Nothing found: sleep until a push or finish. The seq_cst pair (sleepers_ increment here, size_ update in
+            // push_to) guarantees we either see the new item on re-check or the producer sees us and notifies.
+            std::unique_lock<std::mutex> lock(idle_mtx_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            idle_cv_.wait(lock, [&] {
+                return finished_.load(std::memory_order_acquire) || has_work_for(home);
+            });
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (finished_.load(std::memory_order_acquire) && !has_work_for(home)) return std::nullopt;
+        }
+    }
+
+    void set_finished() {
+        finished_.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(idle_mtx_);
+        idle_cv_.notify_all();
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mtx;
+        std::deque<T> items;
+        std::atomic<size_t> size{0}; // Lock-free emptiness check for stealers and sleepers
+    };
+
+    size_t home_shard() const {
+        static std::atomic<size_t> next_id{0};
+        thread_local size_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+        return id % shards_.size();
+    }
+
+    void push_to(size_t index, T item) {
+        Shard& shard = shards_[index];
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            shard.items.push_back(std::move(item));
+            shard.size.fetch_add(1, std::memory_order_seq_cst);
+        }
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(idle_mtx_);
+            // PerKey consumers only serve their own shard, so wake everyone and let the owner pick it up
+            if (ordering_ == Ordering::PerKey) idle_cv_.notify_all();
+            else idle_cv_.notify_one();
+        }
+    }
+
+    std::optional<T> try_pop_shard(size_t index, bool block_on_lock) {
+        Shard& shard = shards_[index];
+        if (shard.size.load(std::memory_order_acquire) == 0) return std::nullopt; // Skip empty shards without locking
+        std::unique_lock<std::mutex> lock(shard.mtx, std::defer_lock);
+        if (block_on_lock) lock.lock();
+        else if (!lock.try_lock()) return std::nullopt; // Someone else is on this shard: try the next one
+        if (shard.items.empty()) return std::nullopt;
+        T item = std::move(shard.items.front());
+        shard.items.pop_front();
+        shard.size.fetch_sub(1, std::memory_order_relaxed);
+        return item;
+    }
+
+    bool has_work_for(size_t home) const {
+        if (ordering_ == Ordering::PerKey) return shards_[home].size.load(std::memory_order_seq_cst) > 0;
+        for (const Shard& s : shards_) {
+            if (s.size.load(std::memory_order_seq_cst) > 0) return true;
+        }
+        return false;
+    }
+
+    std::vector<Shard> shards_;
+    const Ordering ordering_;
+    alignas(64) std::atomic<int> sleepers_{0};
+    std::atomic<bool> finished_{false};
+    std::mutex idle_mtx_;
+    std::condition_variable idle_cv_;
+};
+
+// --- Baseline: the single-mutex queue from 06_task_queue.cpp ---
+template<typename T>
+class ThreadSafeQueue {
+private:
+    std::queue<T> q;
+    mutable std::mutex mtx;
+    std::condition_variable cv_consumer;
+    std::condition_variable cv_producer;
+    size_t max_size;
+    std::atomic<bool> finished = false;
+
+public:
+    ThreadSafeQueue(size_t maxSize = 1000) : max_size(maxSize) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_producer.wait(lock, [this]{ return q.size() < max_size || finished; });
+        if (finished) return;
+        q.push(std::move(item));
+        lock.unlock();
+        cv_consumer.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_consumer.wait(lock, [this]{ return !q.empty() || finished; });
+        if (q.empty()) return std::nullopt;
+        T item = std::move(q.front());
+        q.pop();
+        lock.unlock();
+        cv_producer.notify_one();
+        return item;
+    }
+
+    void set_finished() {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+        cv_consumer.notify_all();
+        cv_producer.notify_all();
+    }
+};
+
+struct Task {
+    int key;
+    long seq;
+};
+
+// Runs `threads` producers and `threads` consumers moving `total` items; returns M items/s and checks the count
+template<typename PushFn, typename PopFn, typename FinishFn>
+double run_throughput(int threads, long total, PushFn push, PopFn pop, FinishFn finish, bool& all_delivered) {
+    std::atomic<long> consumed{0};
+    const long per_producer = total / threads;
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers, producers;
+    for (int c = 0; c < threads; ++c) {
+        consumers.emplace_back([&, c] {
+            long count = 0;
+            while (pop(c)) ++count;
+            consumed += count;
+        });
+    }
+    for (int p = 0; p < threads; ++p) {
+        producers.emplace_back([&, p] {
+            for (long i = 0; i < per_producer; ++i) push(Task{p, i});
+        });
+    }
+    for (auto& t : producers) t.join();
+    finish();
+    for (auto& t : consumers) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    all_delivered = consumed == per_producer * threads;
+    return consumed / secs / 1e6;
+}
+
+int main() {
+    std::cout << "--- Sharded Queue vs single-mutex ThreadSafeQueue ---" << std::endl;
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const long TOTAL = 400'000;
+    std::cout << "Hardware threads: " << hw << ", items per run: " << TOTAL << std::endl;
+    std::cout << "\nP=C   single queue (M/s)   sharded (M/s)   speedup   delivered" << std::endl;
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        bool ok_single = false, ok_sharded = false;
+        ThreadSafeQueue<Task> single(1 << 20);
+        double single_rate = run_throughput(threads, TOTAL,
+            [&](Task t) { single.push(t); },
+            [&](int) { return single.pop().has_value(); },
+            [&] { single.set_finished(); }, ok_single);
+
+        ShardedQueue<Task> sharded(threads);
+        double sharded_rate = run_throughput(threads, TOTAL,
+            [&](Task t) { sharded.push(t); },
+            [&](int c) { return sharded.pop(c).has_value(); },
+            [&] { sharded.set_finished(); }, ok_sharded);
+
+        std::cout << std::setw(3) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(18) << single_rate << std::setw(18) << sharded_rate
+                  << std::setw(10) << sharded_rate / single_rate << "x"
+                  << "   " << (ok_single && ok_sharded ? "Yes" : "No") << std::endl;
+    }
+
+    // --- Per-key ordering: every key's items must come out in push order ---
+    std::cout << "\nPer-key ordering check (8 producers, 8 consumers, 64 keys)" << std::endl;
+    {
+        const int THREADS = 8, KEYS = 64, PER_PRODUCER = 20000;
+        ShardedQueue<Task> keyed(THREADS, Ordering::PerKey);
+        std::vector<std::atomic<long>> next_seq(KEYS);
+        for (auto& s : next_seq) s = 0;
+        std::atomic<long> seq_counter[KEYS];
+        for (auto& s : seq_counter) s = 0;
+        std::atomic<bool> in_order{true};
+        std::atomic<long> consumed{0};
+
+        std::vector<std::thread> consumers, producers;
+        for (int c = 0; c < THREADS; ++c) {
+            consumers.emplace_back([&, c] {
+                while (auto t = keyed.pop(c)) {
+                    // Only this consumer ever sees this key, so the check needs no ordering beyond its own pops
+                    long expected = next_seq[t->key].load(std::memory_order_relaxed);
+                    if (t->seq != expected) in_order = false;
+                    next_seq[t->key].store(t->seq + 1, std::memory_order_relaxed);
+                    ++consumed;
+                }
+            });
+        }
+        std::mutex key_mtx[KEYS]; // Producers share keys: number each key's items under its lock, push in that order
+        for (int p = 0; p < THREADS; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < PER_PRODUCER; ++i) {
+                    int key = (p * 7 + i) % KEYS;
+                    std::lock_guard<std::mutex> lock(key_mtx[key]);
+                    keyed.push_keyed(key, Task{key, seq_counter[key]++});
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        keyed.set_finished();
+        for (auto& t : consumers) t.join();
+        std::cout << "Items: " << consumed << ", per-key order preserved: " << (in_order ? "Yes" : "No") << std::endl;
+    }
+    return 0;
+}
+// Compile with: g++ 24_sharded_queue.cpp -o bin/sharded_queue -pthread -std=c++17 -O2
@@ -0,0 +1,473 @@
+// Parallel Merge: Merge-Path Two-Way Merge, Tournament-Tree K-Way Merge, SIMD Bitonic Leaf Kernel
+// Concept: Merging sorted runs produced by parallel workers is usually done with a chain of std::merge calls on one
+// thread, which touches every element log2(k) (or k) times and uses one core. This example adds:
+//   merge path:   the output of merge(A, B) is split into T equal slices; for each slice boundary a binary search
+//                 along the "diagonal" finds how many elements come from A and from B. Threads then merge their
+//                 slices independently - no communication, perfectly balanced, cache-oblivious (no tuning knob).
+//   bitonic leaf: each thread's merge runs 8 keys at a time through an AVX2 bitonic merge network (min/max +
+//                 shuffles, no branches on data); scalar fallback without AVX2.
+//   loser tree:   a k-way merge that touches each element once: a tournament tree of the run heads where each
+//                 pop replays only log2(k) matches. The parallel version cuts all runs at common splitter values
+//                 so each thread merges an independent slice of every run.
+//   merge tree:   the alternative k-way strategy - a knockout bracket of two-way merge-path merges with the bitonic
+//                 kernel. More passes over memory, but every pass is SIMD and parallel.
+//   external:     runs stored in a file are mmap'd read-only with MADV_SEQUENTIAL, so the kernel streams them in
+//                 with read-ahead and drops pages behind the merge; output goes to an mmap'd file.
+// Benchmarked against std::merge and chains of std::merge.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <immintrin.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Key = int32_t;
+
+// Sorted, read-only run: [begin, end)
+struct Run {
+    const Key* begin;
+    const Key* end;
+    size_t size() const { return static_cast<size_t>(end - begin); }
+};
+
+// --- Scalar two-way merge (also handles the tails of the SIMD kernel) ---
+
+Key* merge_scalar(const Key* a, const Key* a_end, const Key* b, const Key* b_end, Key* out) {
+    while (a != a_end && b != b_end) {
+        // Branch-free select: take from b only if strictly smaller (stable: ties come from a first)
+        bool take_b = *b < *a;
+        *out++ = take_b ? *b : *a;
+        a += !take_b;
+        b += take_b;
+    }
+    out = std::copy(a, a_end, out);
+    return std::copy(b, b_end, out);
+}
+
+// --- AVX2 bitonic merge network ---
+
+// Sort a bitonic 8-vector ascending: compare-exchange at distances 4, 2, 1
+__attribute__((target("avx2")))
+inline __m256i bitonic_clean8(__m256i v) {
+    __m256i s = _mm256_permute2x128_si256(v, v, 0x01);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, s), _mm256_max_epi32(v, s), 0xF0);
+    s = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, s), _mm256_max_epi32(v, s), 0xCC);
+    s = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_blend_epi32(_mm256_min_epi32(v, s), _mm256_max_epi32(v, s), 0xAA);
+}
+
+// a, b sorted ascending -> a = smallest 8 sorted, b = largest 8 sorted
+__attribute__((target("avx2")))
+inline void bitonic_merge_8x8(__m256i& a, __m256i& b) {
+    __m256i rb = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    __m256i lo = _mm256_min_epi32(a, rb);
+    __m256i hi = _mm256_max_epi32(a, rb);
+    a = bitonic_clean8(lo);
+    b = bitonic_clean8(hi);
+}
+
+// Merge 8 keys at a time: keep the 8 largest seen so far in a register, feed the next block from whichever input
+// has the smaller head, emit the 8 smallest. Stops (and finishes scalar) as soon as the input with the smaller head
+// cannot supply a full block, so no emitted key can be larger than a key still waiting.
+__attribute__((target("avx2")))
+Key* merge_avx2(const Key* a, const Key* a_end, const Key* b, const Key* b_end, Key* out) {
+    if (a_end - a < 8 || b_end - b < 8) return merge_scalar(a, a_end, b, b_end, out);
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    a += 8;
+    b += 8;
+    for (;;) {
+        bitonic_merge_8x8(va, vb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), va);
+        out += 8;
+        bool a_left = a != a_end, b_left = b != b_end;
+        bool from_a = a_left && (!b_left || *a <= *b);
+        if (!a_left && !b_left) break;
+        if (from_a) {
+            if (a_end - a < 8) break;
+            va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+            a += 8;
+        } else {
+            if (b_end - b < 8) break;
+            va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            b += 8;
+        }
+    }
+    // 8 carried keys + both tails: merge the carried block with one tail, then with the other
+    alignas(32) Key carry[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(carry), vb);
+    Key tmp[8 + 8];
+    Key* tmp_end;
+    if (a_end - a < b_end - b) { // Short tail into tmp (< 8 keys), then a final merge with the long tail
+        tmp_end = merge_scalar(carry, carry + 8, a, a_end, tmp);
+        return merge_scalar(tmp, tmp_end, b, b_end, out);
+    }
+    tmp_end = merge_scalar(carry, carry + 8, b, b_end, tmp);
+    return merge_scalar(a, a_end, tmp, tmp_end, out);
+}
+
+using MergeFn = Key* (*)(const Key*, const Key*, const Key*, const Key*, Key*);
+
+MergeFn pick_merge_kernel() {
+    if (__builtin_cpu_supports("avx2")) return merge_avx2;
+    return merge_scalar;
+}
+
+// --- Merge path ---
+
+// Number of keys taken from a among the first `diag` outputs of merge(a, b) (stable: a wins ties)
+size_t merge_path_split(const Key* a, size_t na, const Key* b, size_t nb, size_t diag) {
+    size_t lo = diag > nb ? diag - nb : 0;
+    size_t hi = std::min(diag, na);
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (a[mid] <= b[diag - mid - 1]) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void parallel_merge(const Key* a, size_t na, const Key* b, size_t nb, Key* out, int threads, MergeFn kernel) {
+    const size_t total = na + nb;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([=] {
+            size_t d0 = total * t / threads, d1 = total * (t + 1) / threads;
+            size_t i0 = merge_path_split(a, na, b, nb, d0), i1 = merge_path_split(a, na, b, nb, d1);
+            kernel(a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), out + d0);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+// --- Loser tree k-way merge ---
+
+class LoserTree {
+public:
+    explicit LoserTree(std::vector<Run> runs) : runs_(std::move(runs)), k_(runs_.size()), tree_(k_) {
+        if (k_ == 0) return;
+        // Build bottom-up: replay a full tournament once, remembering the loser of every match
+        std::vector<Node> winners(2 * k_);
+        for (size_t i = 0; i < k_; ++i) winners[k_ + i] = {head(i), i};
+        for (size_t node = k_ - 1; node >= 1; --node) {
+            const Node& l = winners[2 * node];
+            const Node& r = winners[2 * node + 1];
+            bool l_wins = l.key <= r.key;
+            winners[node] = l_wins ? l : r;
+            tree_[node] = l_wins ? r : l;
+        }
+        tree_[0] = k_ > 1 ? winners[1] : winners[k_];
+    }
+
+    // Emit everything into out; returns one past the last key written
+    Key* drain(Key* out) {
+        if (k_ == 0) return out;
+        Node winner = tree_[0];
+        while (winner.key != EXHAUSTED) {
+            *out++ = static_cast<Key>(winner.key);
+            Run& run = runs_[winner.run];
+            ++run.begin;
+            winner.key = run.begin == run.end ? EXHAUSTED : *run.begin;
+            // Replay the path from the winner's leaf to the root. Losers carry their key, so each match is one
+            // load and a compare; selects instead of branches because on random keys every match is a coin flip.
+            for (size_t node = (winner.run + k_) / 2; node >= 1; node /= 2) {
+                Node challenger = tree_[node];
+                bool swap = challenger.key < winner.key;
+                tree_[node] = swap ? winner : challenger;
+                winner = swap ? challenger : winner;
+            }
+        }
+        return out;
+    }
+
+private:
+    // Keys are widened to 64 bits so an exhausted run is just a key larger than any Key
+    static constexpr int64_t EXHAUSTED = INT64_MAX;
+
+    struct Node {
+        int64_t key;
+        size_t run;
+    };
+
+    int64_t head(size_t i) const { return runs_[i].begin == runs_[i].end ? EXHAUSTED : *runs_[i].begin; }
+
+    std::vector<Run> runs_;
+    size_t k_;
+    std::vector<Node> tree_; // tree_[0] = initial winner, tree_[1..k) = loser of the match at each internal node
+};
+
+Key* kway_merge(const std::vector<Run>& runs, Key* out) {
+    LoserTree tree(runs);
+    return tree.drain(out);
+}
+
+// Parallel k-way merge: choose T-1 splitter values from a sample of all runs, cut every run at lower_bound(splitter)
+// (all keys < splitter go left). Thread t merges slice t of every run with its own loser tree into its own region.
+void parallel_kway_merge(const std::vector<Run>& runs, Key* out, int threads) {
+    std::vector<Key> sample;
+    for (const Run& r : runs) {
+        size_t n = r.size();
+        for (size_t s = 0; s < 64 && n > 0; ++s) sample.push_back(r.begin[n * s / 64]);
+    }
+    std::sort(sample.begin(), sample.end());
+
+    // cuts[t][r] = start of thread t's slice in run r
+    std::vector<std::vector<const Key*>> cuts(threads + 1, std::vector<const Key*>(runs.size()));
+    for (size_t r = 0; r < runs.size(); ++r) {
+        cuts[0][r] = runs[r].begin;
+        cuts[threads][r] = runs[r].end;
+    }
+    for (int t = 1; t < threads; ++t) {
+        Key splitter = sample.empty() ? 0 : sample[sample.size() * t / threads];
+        for (size_t r = 0; r < runs.size(); ++r) {
+            cuts[t][r] = std::max(cuts[t - 1][r], std::lower_bound(runs[r].begin, runs[r].end, splitter));
+        }
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        size_t offset = 0;
+        for (size_t r = 0; r < runs.size(); ++r) offset += cuts[t][r] - runs[r].begin;
+        workers.emplace_back([&, t, offset] {
+            std::vector<Run> slice(runs.size());
+            for (size_t r = 0; r < runs.size(); ++r) slice[r] = {cuts[t][r], cuts[t + 1][r]};
+            kway_merge(slice, out + offset);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+// Tournament of two-way merges: runs are paired off level by level like the rounds of a knockout bracket, and
+// every match is a merge-path parallel merge with the bitonic leaf kernel. log2(k) passes over the data (vs one
+// for the loser tree), but each pass runs at SIMD speed on all threads. Buffers ping-pong between out and scratch,
+// starting on whichever side makes the last round land in out.
+void merge_tree(const std::vector<Run>& runs, Key* out, std::vector<Key>& scratch, int threads, MergeFn kernel) {
+    size_t total = 0, levels = 0;
+    for (const Run& r : runs) total += r.size();
+    for (size_t width = 1; width < runs.size(); width *= 2) ++levels;
+    if (levels == 0) {
+        if (!runs.empty()) std::copy(runs[0].begin, runs[0].end, out);
+        return;
+    }
+    scratch.resize(total);
+    Key* dest = levels % 2 == 1 ? out : scratch.data();
+    Key* other = dest == out ? scratch.data() : out;
+
+    std::vector<Run> current = runs, next;
+    while (current.size() > 1) {
+        next.clear();
+        Key* cursor = dest;
+        for (size_t i = 0; i < current.size(); i += 2) {
+            Key* begin = cursor;
+            if (i + 1 < current.size()) {
+                parallel_merge(current[i].begin, current[i].size(), current[i + 1].begin, current[i + 1].size(),
+                               cursor, threads, kernel);
+                cursor += current[i].size() + current[i + 1].size();
+            } else {
+                cursor = std::copy(current[i].begin, current[i].end, cursor); // Odd run out: bye to the next round
+            }
+            next.push_back({begin, cursor});
+        }
+        current.swap(next);
+        std::swap(dest, other);
+    }
+}
+
+// Baseline: fold runs one by one with std::merge (what "merge the workers' results" usually looks like)
+void merge_chain(const std::vector<Run>& runs, std::vector<Key>& out) {
+    std::vector<Key> acc(runs[0].begin, runs[0].end), next;
+    for (size_t r = 1; r < runs.size(); ++r) {
+        next.resize(acc.size() + runs[r].size());
+        std::merge(acc.begin(), acc.end(), runs[r].begin, runs[r].end, next.begin());
+        acc.swap(next);
+    }
+    out.swap(acc);
+}
+
+// --- External-memory mode: runs live in a file, merged through mmap ---
+
+struct MappedFile {
+    void* addr = MAP_FAILED;
+    size_t bytes = 0;
+    int fd = -1;
+    ~MappedFile() {
+        if (addr != MAP_FAILED) munmap(addr, bytes);
+        if (fd >= 0) close(fd);
+    }
+};
+
+bool write_file(const std::string& path, const std::vector<Key>& keys) {
+    int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    if (fd < 0) return false;
+    const char* p = reinterpret_cast<const char*>(keys.data());
+    size_t left = keys.size() * sizeof(Key);
+    while (left > 0) {
+        ssize_t n = write(fd, p, std::min<size_t>(left, 1 << 24)); // Large sequential writes
+        if (n <= 0) { close(fd); return false; }
+        p += n;
+        left -= n;
+    }
+    close(fd);
+    return true;
+}
+
+// Merge `run_sizes` consecutive runs stored in `in_path` into `out_path`; returns false on any I/O error
+bool external_merge(const std::string& in_path, const std::vector<size_t>& run_sizes, const std::string& out_path, int threads) {
+    MappedFile in, out;
+    in.fd = open(in_path.c_str(), O_RDONLY);
+    if (in.fd < 0) return false;
+    struct stat st;
+    if (fstat(in.fd, &st) != 0) return false;
+    in.bytes = st.st_size;
+    in.addr = mmap(nullptr, in.bytes, PROT_READ, MAP_PRIVATE, in.fd, 0);
+    if (in.addr == MAP_FAILED) return false;
+    madvise(in.addr, in.bytes, MADV_SEQUENTIAL); // Aggressive read-ahead, drop pages behind the cursor
+
+    out.fd = open(out_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+    if (out.fd < 0 || ftruncate(out.fd, in.bytes) != 0) return false;
+    out.bytes = in.bytes;
+    out.addr = mmap(nullptr, out.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, out.fd, 0);
+    if (out.addr == MAP_FAILED) return false;
+
+    std::vector<Run> runs;
+    const Key* cursor = static_cast<const Key*>(in.addr);
+    for (size_t n : run_sizes) {
+        runs.push_back({cursor, cursor + n});
+        cursor += n;
+    }
+    parallel_kway_merge(runs, static_cast<Key*>(out.addr), threads);
+    return msync(out.addr, out.bytes, MS_SYNC) == 0;
+}
+
+// --- Benchmark helpers ---
+
+template<typename F>
+double time_ms(F fn, int reps = 3) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+std::vector<Key> sorted_random(size_t n, uint32_t seed) {
+    std::vector<Key> v(n);
+    std::mt19937 rng(seed);
+    for (auto& x : v) x = static_cast<Key>(rng() >> 1);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+void print_row(const char* name, double ms, size_t keys, bool ok) {
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << ms << " ms" << std::setw(9) << keys / (ms * 1e3) << " Mkeys/s"
+              << (ok ? "" : "   WRONG RESULT") << std::endl;
+}
+
+int main() {
+    std::cout << "--- Parallel Merge Example ---" << std::endl;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    MergeFn kernel = pick_merge_kernel();
+    std::cout << "Threads: " << threads << ", leaf kernel: " << (kernel == merge_avx2 ? "AVX2 bitonic" : "scalar") << std::endl;
+
+    // --- Two-way merge ---
+    const size_t HALF = 8 * 1024 * 1024;
+    std::vector<Key> a = sorted_random(HALF, 1), b = sorted_random(HALF + 13, 2);
+    std::vector<Key> expected(a.size() + b.size()), out(a.size() + b.size());
+    std::cout << "\nTwo-way merge of " << a.size() << " + " << b.size() << " keys" << std::endl;
+    double t = time_ms([&] { std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin()); });
+    print_row("std::merge", t, out.size(), true);
+    t = time_ms([&] { merge_scalar(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), out.data()); });
+    print_row("branch-free scalar", t, out.size(), out == expected);
+    t = time_ms([&] { kernel(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), out.data()); });
+    print_row("bitonic leaf kernel, 1 thread", t, out.size(), out == expected);
+    std::fill(out.begin(), out.end(), 0);
+    t = time_ms([&] { parallel_merge(a.data(), a.size(), b.data(), b.size(), out.data(), threads, kernel); });
+    print_row("merge path + leaf kernel", t, out.size(), out == expected);
+    std::fill(out.begin(), out.end(), 0);
+    t = time_ms([&] { parallel_merge(a.data(), a.size(), b.data(), b.size(), out.data(), 4 * threads, kernel); });
+    print_row("merge path, 4x oversubscribed", t, out.size(), out == expected);
+
+    // --- K-way merge ---
+    for (int k : {4, 16, 64}) {
+        const size_t TOTAL = 8 * 1024 * 1024;
+        std::vector<std::vector<Key>> run_data;
+        std::vector<Run> runs;
+        for (int r = 0; r < k; ++r) run_data.push_back(sorted_random(TOTAL / k + r, 100 + r));
+        size_t total = 0;
+        for (auto& rd : run_data) {
+            runs.push_back({rd.data(), rd.data() + rd.size()});
+            total += rd.size();
+        }
+        std::cout << "\n" << k << "-way merge of " << total << " keys" << std::endl;
+        std::vector<Key> chain_out, kout(total);
+        t = time_ms([&] { merge_chain(runs, chain_out); }, 1);
+        print_row("std::merge chain", t, total, true);
+        t = time_ms([&] { kway_merge(runs, kout.data()); });
+        print_row("loser tree, 1 thread", t, total, kout == chain_out);
+        std::fill(kout.begin(), kout.end(), 0);
+        t = time_ms([&] { parallel_kway_merge(runs, kout.data(), threads); });
+        print_row("loser tree, parallel slices", t, total, kout == chain_out);
+        std::fill(kout.begin(), kout.end(), 0);
+        std::vector<Key> scratch;
+        t = time_ms([&] { merge_tree(runs, kout.data(), scratch, threads, kernel); });
+        print_row("merge tree (merge path + bitonic)", t, total, kout == chain_out);
+    }
+
+    // --- External-memory mode: 16 runs in a file, merged via mmap ---
+    {
+        const int K = 16;
+        const size_t PER_RUN = 2 * 1024 * 1024;
+        const char* tmpdir = std::getenv("TMPDIR");
+        std::string dir = tmpdir ? tmpdir : "/tmp";
+        std::string in_path = dir + "/parallel_merge_runs.bin", out_path = dir + "/parallel_merge_out.bin";
+        std::vector<Key> all;
+        std::vector<size_t> sizes;
+        for (int r = 0; r < K; ++r) {
+            std::vector<Key> run = sorted_random(PER_RUN, 500 + r);
+            all.insert(all.end(), run.begin(), run.end());
+            sizes.push_back(run.size());
+        }
+        std::cout << "\nExternal " << K << "-way merge via mmap (" << all.size() * sizeof(Key) / (1 << 20) << " MiB, " << dir << ")" << std::endl;
+        if (!write_file(in_path, all)) {
+            std::cout << "Cannot write " << in_path << ", skipping." << std::endl;
+            return 0;
+        }
+        bool io_ok = true;
+        t = time_ms([&] { io_ok &= external_merge(in_path, sizes, out_path, threads); }, 1);
+
+        // Verify by mapping the result back in
+        bool sorted = false;
+        int fd = open(out_path.c_str(), O_RDONLY);
+        if (io_ok && fd >= 0) {
+            size_t bytes = all.size() * sizeof(Key);
+            void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                const Key* k = static_cast<const Key*>(p);
+                sorted = std::is_sorted(k, k + all.size());
+                munmap(p, bytes);
+            }
+        }
+        if (fd >= 0) close(fd);
+        print_row("mmap runs -> parallel loser tree", t, all.size(), io_ok && sorted);
+        std::cout << "Throughput: " << std::setprecision(2) << all.size() * sizeof(Key) / (t * 1e6) << " GB/s (read + write, page cache warm)" << std::endl;
+        unlink(in_path.c_str());
+        unlink(out_path.c_str());
+    }
+    return 0;
+}
+// Compile with: g++ 25_parallel_merge.cpp -o bin/parallel_merge -pthread -std=c++17 -O2
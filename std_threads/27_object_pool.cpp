@@ -0,0 +1,544 @@
+// Lock-Free Object Pool with Per-Thread Magazines
+// Concept: Every task submitted to SimpleThreadPool (14_simple_threadpool.cpp) costs several heap allocations:
+// the packaged_task (make_shared), its future's shared state, the std::function target when the callable does
+// not fit its small buffer, and std::queue's deque blocks. All of these are small, fixed-size objects that die
+// soon after they are born - the ideal case for a dedicated pool:
+//   thread cache:  each thread keeps two "magazines" (arrays of up to 64 free objects). allocate/deallocate pop or
+//                  push the loaded magazine - no atomics, no locks, no sharing.
+//   depot:         when a magazine runs empty (or full) it is exchanged as a whole with the global depot, a
+//                  lock-free stack of full magazines and one of empty magazines. One CAS moves 64 objects, so the
+//                  producer-allocates / worker-frees pattern of a task queue costs 1/64 of a CAS per object.
+//   slabs:         only when the depot has no full magazine are new objects carved from a fresh slab.
+// PoolAllocator<T> routes std::allocator-aware code (std::promise, allocate_shared) to the pool for sizeof(T).
+// Benchmarked: allocator cost in isolation, and the 14_simple_threadpool.cpp workload end to end in three steps so
+// the effects stay separate: the unchanged pool (malloc), the same pool with only its per-task objects moved to
+// FixedPool (allocator effect), and a pool whose queue is intrusive as well (queue-structure effect).
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+
+// --- Global allocation counter: shows what the pool takes off malloc ---
+std::atomic<long> malloc_calls{0};
+
+void* operator new(size_t size) {
+    malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// A batch of free objects moved between a thread cache and the depot as one unit
+struct Magazine {
+    static constexpr int CAPACITY = 64;
+    int count = 0;
+    void* items[CAPACITY];
+    std::atomic<Magazine*> next{nullptr}; // Link while parked in a depot stack
+};
+
+// Treiber stack of magazines. Magazines are never freed while the pool lives, so reading a stale `next` is safe;
+// ABA is prevented by a 16-bit version tag in the top bits of the head (x86-64/AArch64 user pointers use 48 bits).
+class MagazineStack {
+public:
+    void push(Magazine* m) {
+        uint64_t old = head_.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            m->next.store(pointer(old), std::memory_order_relaxed);
+            desired = pack(m, tag(old) + 1);
+        } while (!head_.compare_exchange_weak(old, desired, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    Magazine* pop() {
+        uint64_t old = head_.load(std::memory_order_acquire);
+        for (;;) {
+            Magazine* m = pointer(old);
+            if (m == nullptr) return nullptr;
+            uint64_t desired = pack(m->next.load(std::memory_order_relaxed), tag(old) + 1);
+            if (head_.compare_exchange_weak(old, desired, std::memory_order_acquire, std::memory_order_acquire)) return m;
+        }
+    }
+
+private:
+    static constexpr uint64_t POINTER_MASK = (uint64_t(1) << 48) - 1;
+    static Magazine* pointer(uint64_t v) { return reinterpret_cast<Magazine*>(v & POINTER_MASK); }
+    static uint64_t tag(uint64_t v) { return v >> 48; }
+    static uint64_t pack(Magazine* m, uint64_t t) { return reinterpret_cast<uint64_t>(m) | (t << 48); }
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+// Pool of fixed-size blocks; one instance per size class
+template<size_t ObjectSize>
+class FixedPool {
+public:
+    static constexpr size_t ALIGN = 16; // Blocks only guarantee this alignment (slabs are 64-byte aligned)
+    static constexpr size_t BLOCK = (ObjectSize + ALIGN - 1) / ALIGN * ALIGN;
+
+    static FixedPool& instance() {
+        static FixedPool pool;
+        return pool;
+    }
+
+    void* allocate() {
+        ThreadCache& c = cache();
+        if (c.loaded->count == 0) reload_for_allocate(c);
+        return c.loaded->items[--c.loaded->count];
+    }
+
+    void deallocate(void* p) {
+        ThreadCache& c = cache();
+        if (c.loaded->count == Magazine::CAPACITY) reload_for_deallocate(c);
+        c.loaded->items[c.loaded->count++] = p;
+    }
+
+    long slabs() const { return slabs_.load(std::memory_order_relaxed); }
+    long depot_exchanges() const { return exchanges_.load(std::memory_order_relaxed); }
+
+private:
+    struct ThreadCache {
+        Magazine* loaded;
+        Magazine* previous;
+        explicit ThreadCache(FixedPool& pool) : loaded(pool.empty_magazine()), previous(pool.empty_magazine()) {}
+        ~ThreadCache() { // Thread exit: hand both magazines back so other threads can use the objects
+            FixedPool& pool = instance();
+            pool.park(loaded);
+            pool.park(previous);
+        }
+    };
+
+    FixedPool() = default;
+    ~FixedPool() {
+        // Process exit: free the slabs. Magazines still referenced by live thread caches are leaked on purpose.
+        std::lock_guard<std::mutex> lock(slab_mutex_);
+        for (void* s : slab_list_) std::free(s);
+    }
+
+    static ThreadCache& cache() {
+        thread_local ThreadCache c(instance());
+        return c;
+    }
+
+    void park(Magazine* m) {
+        if (m->count > 0) full_.push(m);
+        else empty_.push(m);
+    }
+
+    Magazine* empty_magazine() {
+        if (Magazine* m = empty_.pop()) return m;
+        return new Magazine; // Rare: the number of magazines is bounded by objects / CAPACITY + 2 per thread
+    }
+
+    // Loaded magazine is empty: use `previous` if it has objects, otherwise trade an empty for a full one
+    void reload_for_allocate(ThreadCache& c) {
+        if (c.previous->count > 0) {
+            std::swap(c.loaded, c.previous);
+            return;
+        }
+        exchanges_.fetch_add(1, std::memory_order_relaxed);
+        empty_.push(c.previous);
+        c.previous = c.loaded;
+        c.loaded = full_.pop();
+        if (c.loaded == nullptr) {
+            c.loaded = empty_magazine();
+            fill_from_new_slab(c.loaded);
+        }
+    }
+
+    // Loaded magazine is full: use `previous` if it has room, otherwise trade a full magazine for an empty one
+    void reload_for_deallocate(ThreadCache& c) {
+        if (c.previous->count < Magazine::CAPACITY) {
+            std::swap(c.loaded, c.previous);
+            return;
+        }
+        exchanges_.fetch_add(1, std::memory_order_relaxed);
+        full_.push(c.previous);
+        c.previous = c.loaded;
+        c.loaded = empty_magazine();
+    }
+
+    void fill_from_new_slab(Magazine* m) {
+        char* slab = static_cast<char*>(std::aligned_alloc(64, (BLOCK * Magazine::CAPACITY + 63) / 64 * 64));
+        if (slab == nullptr) throw std::bad_alloc();
+        {
+            std::lock_guard<std::mutex> lock(slab_mutex_); // Slab growth only; never on the steady-state path
+            slab_list_.push_back(slab);
+        }
+        slabs_.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < Magazine::CAPACITY; ++i) m->items[i] = slab + i * BLOCK;
+        m->count = Magazine::CAPACITY;
+    }
+
+    MagazineStack full_;
+    MagazineStack empty_;
+    std::atomic<long> slabs_{0};
+    std::atomic<long> exchanges_{0};
+    std::mutex slab_mutex_;
+    std::vector<void*> slab_list_;
+};
+
+// Standard allocator backed by the pool of the matching size class (arrays fall back to operator new)
+template<typename T>
+struct PoolAllocator {
+    static_assert(alignof(T) <= FixedPool<sizeof(T)>::ALIGN, "over-aligned types need their own allocator");
+    using value_type = T;
+    PoolAllocator() = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n == 1) return static_cast<T*>(FixedPool<sizeof(T)>::instance().allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (n == 1) FixedPool<sizeof(T)>::instance().deallocate(p);
+        else ::operator delete(p);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+template<typename T, typename... Args>
+T* pool_new(Args&&... args) {
+    static_assert(alignof(T) <= FixedPool<sizeof(T)>::ALIGN, "over-aligned types cannot come from FixedPool");
+    void* p = FixedPool<sizeof(T)>::instance().allocate();
+    return ::new (p) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void pool_delete(T* obj) {
+    obj->~T();
+    FixedPool<sizeof(T)>::instance().deallocate(obj);
+}
+
+// Callable plus the promise for its result; the promise's shared state comes from the pool
+template<typename F, typename R>
+struct PromiseTask {
+    F fn;
+    std::promise<R> promise;
+    explicit PromiseTask(F f) : fn(std::move(f)), promise(std::allocator_arg, PoolAllocator<char>()) {}
+
+    void operator()() {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                fn();
+                promise.set_value();
+            } else {
+                promise.set_value(fn());
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+};
+
+// --- Baseline: SimpleThreadPool from 14_simple_threadpool.cpp (prints removed) ---
+// PoolAllocations = true keeps the structure (std::bind, shared task, std::function queue) and changes only where
+// the task and its shared state are allocated: allocate_shared with PoolAllocator instead of make_shared +
+// packaged_task. std::function's heap target and std::queue's deque blocks still come from malloc, since neither
+// takes an allocator in C++17.
+
+template<bool PoolAllocations>
+class BasicSimpleThreadPool {
+public:
+    explicit BasicSimpleThreadPool(size_t numThreads) : stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex);
+                        condition.wait(lock, [this] { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    template<class F, class... Args>
+    auto enqueue_task(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        std::function<void()> job;
+        std::future<return_type> res;
+        if constexpr (PoolAllocations) {
+            using Task = PromiseTask<decltype(bound), return_type>;
+            auto task_ptr = std::allocate_shared<Task>(PoolAllocator<Task>(), std::move(bound));
+            res = task_ptr->promise.get_future();
+            job = [task_ptr]() { (*task_ptr)(); };
+        } else {
+            auto task_ptr = std::make_shared<std::packaged_task<return_type()>>(std::move(bound));
+            res = task_ptr->get_future();
+            job = [task_ptr]() { (*task_ptr)(); };
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stop) throw std::runtime_error("Enqueue on stopped ThreadPool");
+            tasks.emplace(std::move(job));
+        }
+        condition.notify_one();
+        return res;
+    }
+
+    ~BasicSimpleThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+};
+
+using SimpleThreadPool = BasicSimpleThreadPool<false>;
+using PoolAllocThreadPool = BasicSimpleThreadPool<true>;
+
+// --- Intrusive queue as well: every per-task object from FixedPool ---
+// Tasks are intrusive nodes (no std::function, no deque blocks) allocated with pool_new, and each promise puts its
+// shared state in the pool through PoolAllocator.
+
+struct TaskNode {
+    TaskNode* next = nullptr;
+    virtual void run_and_destroy() = 0;
+    virtual ~TaskNode() = default;
+};
+
+template<typename F, typename R>
+struct PooledTask final : TaskNode {
+    PromiseTask<F, R> task;
+    explicit PooledTask(F f) : task(std::move(f)) {}
+
+    void run_and_destroy() override {
+        task();
+        pool_delete(this);
+    }
+};
+
+class PooledThreadPool {
+public:
+    explicit PooledThreadPool(size_t numThreads) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    TaskNode* task;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex);
+                        condition.wait(lock, [this] { return stop || head != nullptr; });
+                        if (stop && head == nullptr) return;
+                        task = head;
+                        head = head->next;
+                        if (head == nullptr) tail = nullptr;
+                    }
+                    task->run_and_destroy();
+                }
+            });
+        }
+    }
+
+    template<class F>
+    auto enqueue_task(F f) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto* task = pool_new<PooledTask<F, R>>(std::move(f));
+        std::future<R> res = task->task.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stop) {
+                pool_delete(task);
+                throw std::runtime_error("Enqueue on stopped ThreadPool");
+            }
+            if (tail) tail->next = task;
+            else head = task;
+            tail = task;
+        }
+        condition.notify_one();
+        return res;
+    }
+
+    ~PooledThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    TaskNode* head = nullptr;
+    TaskNode* tail = nullptr;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop = false;
+};
+
+// --- Benchmarks ---
+
+using Clock = std::chrono::steady_clock;
+
+double ns_per(Clock::time_point t0, long ops) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+struct Payload64 { char bytes[64]; };
+
+// Allocator cost in isolation: same-thread alloc/free, and the task pattern (one thread allocates, another frees)
+void allocator_microbench() {
+    const long OPS = 4'000'000;
+    constexpr int BATCH = 256;
+    void* ptrs[BATCH];
+
+    auto t0 = Clock::now();
+    for (long i = 0; i < OPS; i += BATCH) {
+        for (int j = 0; j < BATCH; ++j) ptrs[j] = std::malloc(64);
+        for (int j = 0; j < BATCH; ++j) std::free(ptrs[j]);
+    }
+    double malloc_same = ns_per(t0, OPS);
+
+    FixedPool<64>& pool = FixedPool<64>::instance();
+    t0 = Clock::now();
+    for (long i = 0; i < OPS; i += BATCH) {
+        for (int j = 0; j < BATCH; ++j) ptrs[j] = pool.allocate();
+        for (int j = 0; j < BATCH; ++j) pool.deallocate(ptrs[j]);
+    }
+    double pool_same = ns_per(t0, OPS);
+
+    // Cross-thread: producer allocates, consumer frees (hand-off through a small mutex-protected vector)
+    auto cross = [&](auto alloc, auto release) {
+        std::mutex m;
+        std::condition_variable cv;
+        std::vector<void*> handoff;
+        bool done = false;
+        auto start = Clock::now();
+        std::thread consumer([&] {
+            std::vector<void*> local;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    cv.wait(lock, [&] { return done || !handoff.empty(); });
+                    if (handoff.empty() && done) return;
+                    local.swap(handoff);
+                }
+                for (void* p : local) release(p);
+                local.clear();
+            }
+        });
+        std::vector<void*> batch;
+        batch.reserve(BATCH);
+        for (long i = 0; i < OPS; i += BATCH) {
+            for (int j = 0; j < BATCH; ++j) batch.push_back(alloc());
+            {
+                std::lock_guard<std::mutex> lock(m);
+                handoff.insert(handoff.end(), batch.begin(), batch.end());
+            }
+            cv.notify_one();
+            batch.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m);
+            done = true;
+        }
+        cv.notify_one();
+        consumer.join();
+        return ns_per(start, OPS);
+    };
+    double malloc_cross = cross([] { return std::malloc(64); }, [](void* p) { std::free(p); });
+    double pool_cross = cross([&] { return pool.allocate(); }, [&](void* p) { pool.deallocate(p); });
+
+    std::cout << "Allocator cost (64-byte objects, ns per alloc+free)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "                       malloc     FixedPool" << std::endl;
+    std::cout << "same thread        " << std::setw(9) << malloc_same << std::setw(12) << pool_same << std::endl;
+    std::cout << "alloc A / free B   " << std::setw(9) << malloc_cross << std::setw(12) << pool_cross
+              << "   (depot exchanges so far: " << pool.depot_exchanges() << ", slabs: " << pool.slabs() << ")" << std::endl;
+}
+
+// The 14_simple_threadpool.cpp workload: many tiny tasks returning a value through a future
+template<typename Pool>
+double pool_workload(const char* name, Pool& pool, long tasks) {
+    const long BATCH = 4096;
+    std::vector<std::future<long>> futures;
+    futures.reserve(BATCH);
+    long checksum = 0;
+
+    // Warm-up round so both pools start from their steady state (pool slabs / malloc arenas already grown)
+    for (long i = 0; i < BATCH; ++i) futures.push_back(pool.enqueue_task([i] { return i * 2; }));
+    for (auto& f : futures) f.get();
+    futures.clear();
+
+    long allocs_before = malloc_calls.load();
+    auto t0 = Clock::now();
+    for (long done = 0; done < tasks; done += BATCH) {
+        for (long i = 0; i < std::min(BATCH, tasks - done); ++i) {
+            long id = done + i;
+            futures.push_back(pool.enqueue_task([id] { return id * 2; }));
+        }
+        for (auto& f : futures) checksum += f.get();
+        futures.clear();
+    }
+    double ns = ns_per(t0, tasks);
+    long allocs = malloc_calls.load() - allocs_before;
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(8) << std::setprecision(0) << ns
+              << " ns/task" << std::setw(8) << std::setprecision(2) << double(allocs) / tasks << " mallocs/task"
+              << "   checksum " << (checksum == tasks * (tasks - 1) ? "ok" : "WRONG") << std::endl;
+    return ns;
+}
+
+int main() {
+    std::cout << "--- Lock-Free Object Pool (thread magazines + global depot) ---" << std::endl;
+    allocator_microbench();
+
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    const long TASKS = 1'000'000;
+    std::cout << "\nThread pool workload: " << TASKS << " tasks, " << workers << " workers" << std::endl;
+    double baseline, pool_alloc, pooled;
+    {
+        SimpleThreadPool pool(workers);
+        baseline = pool_workload("SimpleThreadPool (malloc)", pool, TASKS);
+    }
+    {
+        PoolAllocThreadPool pool(workers);
+        pool_alloc = pool_workload("SimpleThreadPool (FixedPool allocs)", pool, TASKS);
+    }
+    {
+        PooledThreadPool pool(workers);
+        pooled = pool_workload("+ intrusive queue (FixedPool)", pool, TASKS);
+    }
+    auto saved = [&](const char* what, double before, double after) {
+        std::cout << what << std::setprecision(0) << std::setw(6) << before - after << " ns/task ("
+                  << std::setprecision(1) << 100.0 * (before - after) / baseline << "% of baseline)" << std::endl;
+    };
+    saved("Saved by the allocator alone:  ", baseline, pool_alloc);
+    saved("Saved by the intrusive queue:  ", pool_alloc, pooled);
+    return 0;
+}
+// Compile with: g++ 27_object_pool.cpp -o bin/object_pool -pthread -std=c++17 -O2
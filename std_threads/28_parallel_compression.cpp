@@ -0,0 +1,455 @@
+// Block-Parallel Compression Stage with an In-Order Reorder Buffer
+// Concept: A 06_task_queue.cpp-style pipeline that ends in a single-threaded compressor runs at the compressor's
+// speed (a few hundred MB/s per core for fast LZ codecs), no matter how many producers feed it. Splitting the
+// stream into INDEPENDENT blocks makes compression embarrassingly parallel:
+//   reader:    cuts the input into BLOCK-byte blocks, numbers them, submits one compress task per block to the
+//              pool - but only while fewer than WINDOW blocks are in flight (bounds memory, applies backpressure).
+//   workers:   compress blocks in whatever order the pool runs them and hand the result to the reorder buffer.
+//   writer:    takes block 0, 1, 2, ... from the reorder buffer, so the output is byte-identical to a sequential
+//              compressor using the same block size, and frees a window slot per block written.
+// Each block is framed as [raw size][stored size][payload], so decompression can also run block-parallel:
+// one sequential pass over the headers finds every block, then blocks decode straight into their output offset.
+// Codec is pluggable: a built-in LZ77 codec (LZ4-style sequences, 64 KiB window) is always available; build with
+// -DUSE_ZLIB -lz to also benchmark zlib level 1 through the same interface.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+// --- Codec interface ---
+struct Codec {
+    const char* name;
+    size_t (*bound)(size_t raw_size);                                              // Worst-case compressed size
+    size_t (*compress)(const uint8_t* src, size_t n, uint8_t* dst, size_t cap);     // Returns 0 on failure
+    bool (*decompress)(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_size);
+};
+
+// --- Built-in LZ77 codec ---
+// Stream of sequences: token (literal length << 4 | (match length - 4)), extra literal-length bytes (255-runs
+// when the nibble is 15), the literals, a 16-bit little-endian offset, extra match-length bytes. The last
+// sequence has literals only: the decoder stops when the input ends right after them.
+namespace lz {
+
+constexpr int MIN_MATCH = 4;
+constexpr int HASH_BITS = 14;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr size_t TAIL = 12; // No match may start in the last TAIL bytes (keeps the 4-byte reads in bounds)
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash4(uint32_t v) { return (v * 2654435761u) >> (32 - HASH_BITS); }
+
+inline uint8_t* write_length(uint8_t* op, size_t len) { // Continuation of a nibble that was saturated at 15
+    while (len >= 255) { *op++ = 255; len -= 255; }
+    *op++ = uint8_t(len);
+    return op;
+}
+
+size_t bound(size_t n) { return n + n / 255 + 16; }
+
+size_t compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap) {
+    if (cap < bound(n)) return 0;
+    thread_local std::vector<uint32_t> table(size_t(1) << HASH_BITS); // Position + 1 of the last 4-gram per hash
+    std::fill(table.begin(), table.end(), 0);
+
+    uint8_t* op = dst;
+    size_t anchor = 0, i = 0;
+    auto emit = [&](size_t lit_end, size_t offset, size_t match_len) {
+        const size_t lit = lit_end - anchor;
+        uint8_t* token = op++;
+        *token = uint8_t(std::min<size_t>(lit, 15) << 4);
+        if (lit >= 15) op = write_length(op, lit - 15);
+        std::memcpy(op, src + anchor, lit);
+        op += lit;
+        if (match_len == 0) return; // Final literal-only sequence
+        *op++ = uint8_t(offset);
+        *op++ = uint8_t(offset >> 8);
+        const size_t m = match_len - MIN_MATCH;
+        *token |= uint8_t(std::min<size_t>(m, 15));
+        if (m >= 15) op = write_length(op, m - 15);
+    };
+
+    while (n > TAIL && i < n - TAIL) {
+        const uint32_t v = read32(src + i);
+        uint32_t& slot = table[hash4(v)];
+        const size_t cand = slot;
+        slot = uint32_t(i + 1);
+        if (cand == 0 || i - (cand - 1) > MAX_OFFSET || read32(src + cand - 1) != v) {
+            i += 1 + ((i - anchor) >> 6); // Skip faster through incompressible stretches
+            continue;
+        }
+        const size_t from = cand - 1;
+        size_t len = MIN_MATCH;
+        while (i + len < n && src[from + len] == src[i + len]) ++len;
+        emit(i, i - from, len);
+        i += len;
+        anchor = i;
+    }
+    emit(n, 0, 0);
+    return op - dst;
+}
+
+bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_size) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + n;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + raw_size;
+    auto read_length = [&](size_t len) -> size_t {
+        if (len != 15) return len;
+        uint8_t b;
+        do {
+            if (ip >= iend) return SIZE_MAX;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return len;
+    };
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+        const size_t lit = read_length(token >> 4);
+        if (lit == SIZE_MAX || lit > size_t(iend - ip) || lit > size_t(oend - op)) return false;
+        std::memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend) break; // Final sequence
+        if (iend - ip < 2) return false;
+        const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+        ip += 2;
+        size_t len = read_length(token & 15);
+        if (len == SIZE_MAX || offset == 0 || offset > size_t(op - dst)) return false;
+        len += MIN_MATCH;
+        if (len > size_t(oend - op)) return false;
+        const uint8_t* match = op - offset;
+        if (offset >= len) {
+            std::memcpy(op, match, len);
+        } else {
+            for (size_t k = 0; k < len; ++k) op[k] = match[k]; // Overlapping copy repeats the last `offset` bytes
+        }
+        op += len;
+    }
+    return op == oend;
+}
+
+} // namespace lz
+
+const Codec LZ_CODEC = {"lz (built-in)", lz::bound, lz::compress, lz::decompress};
+
+#ifdef USE_ZLIB
+const Codec ZLIB_CODEC = {
+    "zlib level 1",
+    [](size_t n) -> size_t { return compressBound(uLong(n)); },
+    [](const uint8_t* src, size_t n, uint8_t* dst, size_t cap) -> size_t {
+        uLongf out = uLongf(cap);
+        return compress2(dst, &out, src, uLong(n), 1) == Z_OK ? size_t(out) : 0;
+    },
+    [](const uint8_t* src, size_t n, uint8_t* dst, size_t raw_size) -> bool {
+        uLongf out = uLongf(raw_size);
+        return uncompress(dst, &out, src, uLong(n)) == Z_OK && out == raw_size;
+    },
+};
+#endif
+
+// --- SimpleThreadPool from 14_simple_threadpool.cpp (prints removed) ---
+class SimpleThreadPool {
+public:
+    explicit SimpleThreadPool(size_t numThreads) : stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex);
+                        condition.wait(lock, [this] { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    void enqueue(std::function<void()> f) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stop) throw std::runtime_error("Enqueue on stopped ThreadPool");
+            tasks.emplace(std::move(f));
+        }
+        condition.notify_one();
+    }
+
+    ~SimpleThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+};
+
+// --- Framing ---
+constexpr uint32_t STORED_RAW = 0x80000000u; // Stored-size flag: payload is the raw block (codec did not help)
+
+struct Block {
+    uint32_t raw_size = 0;
+    uint32_t stored_size = 0; // Includes the STORED_RAW flag
+    std::vector<uint8_t> payload;
+};
+
+Block compress_block(const Codec& codec, const uint8_t* src, size_t n) {
+    Block b;
+    b.raw_size = uint32_t(n);
+    b.payload.resize(codec.bound(n));
+    size_t c = codec.compress(src, n, b.payload.data(), b.payload.size());
+    if (c == 0 || c >= n) {
+        b.payload.assign(src, src + n);
+        b.stored_size = uint32_t(n) | STORED_RAW;
+    } else {
+        b.payload.resize(c);
+        b.stored_size = uint32_t(c);
+    }
+    return b;
+}
+
+void append_block(std::vector<uint8_t>& out, const Block& b) {
+    uint8_t header[8];
+    std::memcpy(header, &b.raw_size, 4);
+    std::memcpy(header + 4, &b.stored_size, 4);
+    out.insert(out.end(), header, header + 8);
+    out.insert(out.end(), b.payload.begin(), b.payload.end());
+}
+
+// --- Reorder buffer: completes out of order, releases in sequence order, bounds blocks in flight ---
+class ReorderBuffer {
+public:
+    explicit ReorderBuffer(size_t window) : window_(window) {}
+
+    // Reader: block `seq` may be submitted once it is within WINDOW of the next block to be written
+    void acquire_slot(uint64_t seq) {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_space_.wait(lock, [&] { return seq < next_emit_ + window_; });
+    }
+
+    // Worker: publish a finished block. Notify while holding m_: once the writer can see the last block,
+    // parallel_compress may return and destroy this buffer, so nothing may touch it after the unlock
+    void complete(uint64_t seq, Block block) {
+        std::lock_guard<std::mutex> lock(m_);
+        done_.emplace(seq, std::move(block));
+        cv_ready_.notify_one();
+    }
+
+    // Reader: no block numbered >= total will ever arrive
+    void close(uint64_t total) {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            total_ = total;
+        }
+        cv_ready_.notify_one();
+    }
+
+    // Writer: next block in sequence order; false once every block has been handed out
+    bool pop_next(Block& out) {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_ready_.wait(lock, [&] { return next_emit_ >= total_ || done_.count(next_emit_) != 0; });
+        if (next_emit_ >= total_) return false;
+        auto it = done_.find(next_emit_);
+        out = std::move(it->second);
+        done_.erase(it);
+        ++next_emit_;
+        lock.unlock();
+        cv_space_.notify_one();
+        return true;
+    }
+
+private:
+    std::mutex m_;
+    std::condition_variable cv_space_, cv_ready_;
+    std::map<uint64_t, Block> done_;
+    uint64_t next_emit_ = 0;
+    uint64_t total_ = UINT64_MAX;
+    const size_t window_;
+};
+
+// --- Parallel stages ---
+
+std::vector<uint8_t> parallel_compress(const Codec& codec, const std::vector<uint8_t>& input, size_t block_size,
+                                       SimpleThreadPool& pool, size_t window) {
+    ReorderBuffer rob(window);
+    std::vector<uint8_t> out;
+    out.reserve(input.size() / 2);
+
+    std::thread writer([&] {
+        Block b;
+        while (rob.pop_next(b)) append_block(out, b);
+    });
+
+    uint64_t seq = 0;
+    for (size_t off = 0; off < input.size(); off += block_size, ++seq) {
+        rob.acquire_slot(seq);
+        const size_t n = std::min(block_size, input.size() - off);
+        pool.enqueue([&codec, &rob, &input, seq, off, n] {
+            rob.complete(seq, compress_block(codec, input.data() + off, n));
+        });
+    }
+    rob.close(seq);
+    writer.join();
+    return out;
+}
+
+// Header scan is sequential and cheap; every block then decodes independently into its own output range
+bool parallel_decompress(const Codec& codec, const std::vector<uint8_t>& framed, std::vector<uint8_t>& out,
+                         SimpleThreadPool& pool) {
+    struct Entry { size_t in_off, stored, out_off, raw; bool is_raw; };
+    std::vector<Entry> index;
+    size_t pos = 0, total_raw = 0;
+    while (pos + 8 <= framed.size()) {
+        uint32_t raw, stored;
+        std::memcpy(&raw, &framed[pos], 4);
+        std::memcpy(&stored, &framed[pos + 4], 4);
+        const size_t len = stored & ~STORED_RAW;
+        if (pos + 8 + len > framed.size()) return false;
+        index.push_back({pos + 8, len, total_raw, raw, (stored & STORED_RAW) != 0});
+        total_raw += raw;
+        pos += 8 + len;
+    }
+    if (pos != framed.size()) return false;
+
+    out.resize(total_raw);
+    std::vector<std::future<bool>> results;
+    results.reserve(index.size());
+    for (const Entry& e : index) {
+        auto task = std::make_shared<std::packaged_task<bool()>>([&codec, &framed, &out, e] {
+            if (e.is_raw) {
+                if (e.stored != e.raw) return false;
+                std::memcpy(&out[e.out_off], &framed[e.in_off], e.raw);
+                return true;
+            }
+            return codec.decompress(&framed[e.in_off], e.stored, &out[e.out_off], e.raw);
+        });
+        results.push_back(task->get_future());
+        pool.enqueue([task] { (*task)(); });
+    }
+    bool ok = true;
+    for (auto& r : results) ok &= r.get();
+    return ok;
+}
+
+// Baseline: the single-threaded compressor at the end of a pipeline
+std::vector<uint8_t> sequential_compress(const Codec& codec, const std::vector<uint8_t>& input, size_t block_size) {
+    std::vector<uint8_t> out;
+    out.reserve(input.size() / 2);
+    for (size_t off = 0; off < input.size(); off += block_size)
+        append_block(out, compress_block(codec, input.data() + off, std::min(block_size, input.size() - off)));
+    return out;
+}
+
+// --- Benchmark ---
+
+// Log-like text: repetitive structure with varying numbers, similar to what our pipelines emit
+std::vector<uint8_t> make_input(size_t bytes) {
+    static const char* levels[] = {"INFO", "DEBUG", "WARN", "ERROR"};
+    static const char* actions[] = {"login", "logout", "checkout", "search", "view_item", "add_to_cart", "payment"};
+    std::mt19937 rng(2024);
+    std::vector<uint8_t> out;
+    out.reserve(bytes + 256);
+    char line[256];
+    long t = 1700000000000;
+    while (out.size() < bytes) {
+        t += rng() % 50;
+        int len = std::snprintf(line, sizeof(line), "%ld %s worker-%u user=%u action=%s latency_us=%u status=%u\n",
+                                t, levels[rng() % 4], unsigned(rng() % 16), unsigned(rng() % 100000),
+                                actions[rng() % 7], unsigned(rng() % 5000), rng() % 8 == 0 ? 500u : 200u);
+        out.insert(out.end(), line, line + len);
+    }
+    out.resize(bytes);
+    return out;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+void benchmark_codec(const Codec& codec, const std::vector<uint8_t>& input, size_t block_size, size_t window) {
+    const double gb = input.size() / 1e9;
+    auto t0 = Clock::now();
+    std::vector<uint8_t> reference = sequential_compress(codec, input, block_size);
+    const double seq_s = seconds_since(t0);
+    std::cout << "\nCodec: " << codec.name << ", ratio " << std::fixed << std::setprecision(2)
+              << double(input.size()) / reference.size() << "x" << std::endl;
+    std::cout << "  sequential compressor:    " << std::setw(6) << gb / seq_s << " GB/s" << std::endl;
+
+    std::vector<int> thread_counts;
+    const int hw = std::max(1u, std::thread::hardware_concurrency());
+    for (int t = 1; t <= std::max(4, hw); t *= 2) thread_counts.push_back(t);
+
+    std::cout << "  threads   compress GB/s   speedup   decompress GB/s   identical   roundtrip" << std::endl;
+    for (int t : thread_counts) {
+        SimpleThreadPool pool(t);
+        double best_c = 1e30, best_d = 1e30;
+        std::vector<uint8_t> framed, restored;
+        bool ok = true;
+        for (int rep = 0; rep < 3; ++rep) {
+            t0 = Clock::now();
+            framed = parallel_compress(codec, input, block_size, pool, window);
+            best_c = std::min(best_c, seconds_since(t0));
+            t0 = Clock::now();
+            ok &= parallel_decompress(codec, framed, restored, pool);
+            best_d = std::min(best_d, seconds_since(t0));
+        }
+        std::cout << "  " << std::setw(7) << t << std::setw(16) << gb / best_c << std::setw(10) << seq_s / best_c
+                  << std::setw(18) << gb / best_d << std::setw(12) << (framed == reference ? "Yes" : "NO")
+                  << std::setw(12) << (ok && restored == input ? "Yes" : "NO") << std::endl;
+    }
+}
+
+int main() {
+    const size_t INPUT = 32u << 20;
+    const size_t BLOCK = 256u << 10;   // Larger blocks compress better; smaller ones parallelize and pipeline better
+    const size_t WINDOW = 4 * std::max(1u, std::thread::hardware_concurrency()); // Blocks in flight
+
+    std::cout << "--- Block-Parallel Compression (pool + reorder buffer) ---" << std::endl;
+    std::vector<uint8_t> input = make_input(INPUT);
+    std::cout << "Input: " << (INPUT >> 20) << " MiB of log lines, block " << (BLOCK >> 10) << " KiB, window "
+              << WINDOW << " blocks" << std::endl;
+
+    benchmark_codec(LZ_CODEC, input, BLOCK, WINDOW);
+#ifdef USE_ZLIB
+    benchmark_codec(ZLIB_CODEC, input, BLOCK, WINDOW);
+#endif
+    return 0;
+}
+// Compile with: g++ 28_parallel_compression.cpp -o bin/parallel_compression -pthread -std=c++17 -O2
+//          or:  g++ 28_parallel_compression.cpp -o bin/parallel_compression -pthread -std=c++17 -O2 -DUSE_ZLIB -lz
@@ -0,0 +1,369 @@
+// False-Sharing Detector (instrumented accesses + per-line sharing analysis + coherence accounting)
+// Concept: 13_false_sharing.cpp shows false sharing only as a timing difference. This tool finds it:
+//   1. Instrumentation: shared variables are declared as Tracked<T> (same size and layout as std::atomic<T>).
+//      Every access goes through a hook that appends (address, size, read/write) to a per-thread log,
+//      sampled 1 in SAMPLE_EVERY accesses so the workload keeps its shape.
+//   2. Symbolization: objects register their address range and fields (name, offsetof, sizeof), so a raw
+//      address becomes "counters_unpadded.CounterB +0".
+//   3. Analysis: accesses are grouped by 64-byte cache line. A line written by 2+ threads is shared; if the bytes
+//      each thread touches are disjoint it is FALSE sharing (fixable by padding), otherwise TRUE sharing.
+//   4. Coherence accounting: EVERY access (not just the sampled ones) updates a per-line holder set with
+//      MESI-style rules - a write invalidates all other holders, a read adds a shared copy - so the invalidation
+//      count per line is exact for the order the accesses were applied in. Sampling a trace and replaying it
+//      would miss almost every ownership change, since consecutive samples are 16 accesses apart.
+// Hardware alternative: `perf c2c record` / `perf mem` use PEBS load/store data addresses with no code changes,
+// but need PMU access (often unavailable in containers and VMs). This approach needs no PMU, but it is not
+// free: every suspect variable has to be retyped as Tracked<T>, and objects/fields registered with the
+// SymbolTable by hand (FS_FIELD) before the report can name them.
+// Demonstrated on Counters vs PaddedCounters from 13_false_sharing.cpp, plus a per-thread slot array and a
+// truly shared counter.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstddef> // offsetof
+#include <cstdint>
+#include <new>
+
+#ifdef __cpp_lib_hardware_interference_size
+    constexpr size_t cache_line_size = std::hardware_destructive_interference_size;
+#else
+    constexpr size_t cache_line_size = 64;
+#endif
+
+constexpr uint64_t SAMPLE_EVERY = 16; // Record 1 access in 16 per thread
+
+// --- Per-thread access logs ---
+struct Access {
+    uintptr_t addr;
+    uint32_t size;
+    bool write;
+};
+
+struct ThreadLog {
+    int tid;
+    uint64_t seen = 0; // All accesses, sampled or not
+    std::vector<Access> entries;
+};
+
+class AccessRecorder {
+public:
+    static AccessRecorder& instance() {
+        static AccessRecorder recorder;
+        return recorder;
+    }
+
+    void record(const void* addr, uint32_t size, bool write) {
+        ThreadLog& log = local_log();
+        track_coherence(reinterpret_cast<uintptr_t>(addr) / cache_line_size, log.tid, write);
+        if (log.seen++ % SAMPLE_EVERY != 0) return;
+        log.entries.push_back({reinterpret_cast<uintptr_t>(addr), size, write});
+    }
+
+    // Call only while no instrumented threads are running
+    std::vector<ThreadLog*> logs() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<ThreadLog*> out;
+        for (auto& l : logs_) out.push_back(l.get());
+        return out;
+    }
+
+    // Invalidations counted for one line (line number = address / cache_line_size), over all accesses
+    uint64_t invalidations(uintptr_t line) const {
+        for (size_t i = 0; i < LINE_SLOTS; ++i) {
+            const LineState& s = lines_[(line + i) % LINE_SLOTS];
+            const uintptr_t tag = s.line.load(std::memory_order_relaxed);
+            if (tag == line) return s.invalidations.load(std::memory_order_relaxed);
+            if (tag == 0) break;
+        }
+        return 0;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& l : logs_) { l->entries.clear(); l->seen = 0; }
+        for (LineState& s : lines_) {
+            s.line.store(0, std::memory_order_relaxed);
+            s.holders.store(0, std::memory_order_relaxed);
+            s.invalidations.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Per-line coherence state, in a fixed lock-free open-addressing table (tag 0 = free slot)
+    static constexpr size_t LINE_SLOTS = 4096;
+    struct LineState {
+        std::atomic<uintptr_t> line{0};
+        std::atomic<uint64_t> holders{0}; // Bit per thread holding a copy (tids past 64 alias)
+        std::atomic<uint64_t> invalidations{0};
+    };
+
+    LineState* find_line(uintptr_t line) {
+        for (size_t i = 0; i < LINE_SLOTS; ++i) {
+            LineState& s = lines_[(line + i) % LINE_SLOTS];
+            uintptr_t tag = s.line.load(std::memory_order_relaxed);
+            if (tag == 0 && s.line.compare_exchange_strong(tag, line, std::memory_order_relaxed)) return &s;
+            if (tag == line) return &s;
+        }
+        return nullptr; // Table full: the line goes uncounted
+    }
+
+    void track_coherence(uintptr_t line, int tid, bool write) {
+        LineState* s = find_line(line);
+        if (s == nullptr) return;
+        const uint64_t me = 1ull << ((tid - 1) % 64);
+        if (write) {
+            if (s->holders.load(std::memory_order_relaxed) == me) return; // Already exclusive (M/E)
+            const uint64_t others = s->holders.exchange(me, std::memory_order_relaxed) & ~me;
+            if (others != 0) s->invalidations.fetch_add(__builtin_popcountll(others), std::memory_order_relaxed);
+        } else if ((s->holders.load(std::memory_order_relaxed) & me) == 0) {
+            s->holders.fetch_or(me, std::memory_order_relaxed); // Fetch a shared copy (demotes a modified owner)
+        }
+    }
+
+    // Logs are owned here, not by the thread, so they survive thread exit until the analysis runs
+    ThreadLog& local_log() {
+        thread_local ThreadLog* log = nullptr;
+        if (log == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            logs_.push_back(std::make_unique<ThreadLog>());
+            log = logs_.back().get();
+            log->tid = static_cast<int>(logs_.size());
+            log->entries.reserve(1 << 16);
+        }
+        return *log;
+    }
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadLog>> logs_;
+    LineState lines_[LINE_SLOTS];
+};
+
+// Drop-in for std::atomic<T>: same size and alignment, so struct layouts (and false sharing) are unchanged
+template<typename T>
+class Tracked {
+public:
+    Tracked(T initial = T()) : value_(initial) {}
+
+    T load(std::memory_order order = std::memory_order_seq_cst) const {
+        AccessRecorder::instance().record(this, sizeof(T), false);
+        return value_.load(order);
+    }
+    void store(T v, std::memory_order order = std::memory_order_seq_cst) {
+        AccessRecorder::instance().record(this, sizeof(T), true);
+        value_.store(v, order);
+    }
+    T fetch_add(T v, std::memory_order order = std::memory_order_seq_cst) {
+        AccessRecorder::instance().record(this, sizeof(T), true);
+        return value_.fetch_add(v, order);
+    }
+    operator T() const { return load(); }
+
+private:
+    std::atomic<T> value_;
+};
+static_assert(sizeof(Tracked<long long>) == sizeof(std::atomic<long long>), "Tracked must not change layout");
+
+// --- Symbolization: address -> variable name + offset ---
+struct FieldInfo {
+    std::string name;
+    size_t offset;
+    size_t size;
+};
+#define FS_FIELD(Type, member) FieldInfo{#member, offsetof(Type, member), sizeof(Type::member)}
+
+class SymbolTable {
+public:
+    void add_object(const std::string& name, const void* base, size_t size, std::vector<FieldInfo> fields = {}) {
+        objects_.push_back({name, reinterpret_cast<uintptr_t>(base), size, 0, std::move(fields)});
+    }
+    void add_array(const std::string& name, const void* base, size_t count, size_t elem_size) {
+        objects_.push_back({name, reinterpret_cast<uintptr_t>(base), count * elem_size, elem_size, {}});
+    }
+
+    std::string describe(uintptr_t addr) const {
+        for (const Object& o : objects_) {
+            if (addr < o.base || addr >= o.base + o.size) continue;
+            size_t off = addr - o.base;
+            if (o.elem_size != 0) {
+                return o.name + "[" + std::to_string(off / o.elem_size) + "] +" + std::to_string(off % o.elem_size);
+            }
+            for (const FieldInfo& f : o.fields) {
+                if (off >= f.offset && off < f.offset + f.size)
+                    return o.name + "." + f.name + " +" + std::to_string(off - f.offset);
+            }
+            return o.name + " +" + std::to_string(off);
+        }
+        return "<unregistered>";
+    }
+
+private:
+    struct Object {
+        std::string name;
+        uintptr_t base;
+        size_t size;
+        size_t elem_size; // Non-zero for arrays
+        std::vector<FieldInfo> fields;
+    };
+    std::vector<Object> objects_;
+};
+
+// --- Analysis ---
+struct ThreadUse {
+    uint64_t reads = 0, writes = 0;
+    uint64_t read_mask = 0, write_mask = 0; // Bytes of the line touched (bit i = byte i)
+    std::set<uintptr_t> write_addrs;
+};
+
+struct LineReport {
+    uintptr_t line;
+    std::map<int, ThreadUse> threads;
+    uint64_t invalidations = 0; // Counted on every access, not sampled
+    bool false_sharing = false;
+};
+
+inline uint64_t byte_mask(uintptr_t addr, uint32_t size) {
+    const unsigned first = addr % cache_line_size;
+    const unsigned n = std::min<unsigned>(size, cache_line_size - first);
+    return (n >= 64 ? ~0ull : ((1ull << n) - 1)) << first;
+}
+
+std::vector<LineReport> analyze(const std::vector<ThreadLog*>& logs) {
+    struct Event { int tid; uintptr_t addr; uint32_t size; bool write; };
+    std::map<uintptr_t, std::vector<Event>> by_line;
+    for (const ThreadLog* log : logs)
+        for (const Access& a : log->entries)
+            by_line[a.addr / cache_line_size].push_back({log->tid, a.addr, a.size, a.write});
+
+    std::vector<LineReport> reports;
+    for (auto& [line, events] : by_line) {
+        LineReport r;
+        r.line = line * cache_line_size;
+        for (const Event& e : events) {
+            ThreadUse& u = r.threads[e.tid];
+            const uint64_t mask = byte_mask(e.addr, e.size);
+            if (e.write) { ++u.writes; u.write_mask |= mask; u.write_addrs.insert(e.addr); }
+            else { ++u.reads; u.read_mask |= mask; }
+        }
+        int writers = 0;
+        for (auto& [tid, u] : r.threads) writers += u.writes > 0;
+        if (writers == 0 || r.threads.size() < 2) continue; // Private or read-only lines are never contended
+
+        // False sharing: no byte written by one thread is touched by another thread
+        bool overlap = false;
+        for (auto& [t1, u1] : r.threads)
+            for (auto& [t2, u2] : r.threads)
+                if (t1 != t2 && (u1.write_mask & (u2.write_mask | u2.read_mask)) != 0) overlap = true;
+        r.false_sharing = !overlap;
+        r.invalidations = AccessRecorder::instance().invalidations(line);
+        reports.push_back(std::move(r));
+    }
+    std::sort(reports.begin(), reports.end(),
+              [](const LineReport& a, const LineReport& b) { return a.invalidations > b.invalidations; });
+    return reports;
+}
+
+std::string byte_range(uint64_t mask) {
+    if (mask == 0) return "-";
+    const int lo = __builtin_ctzll(mask), hi = 64 - __builtin_clzll(mask);
+    return "[" + std::to_string(lo) + "," + std::to_string(hi) + ")";
+}
+
+void print_report(const std::string& title, const SymbolTable& symbols) {
+    auto logs = AccessRecorder::instance().logs();
+    uint64_t sampled = 0;
+    for (const ThreadLog* l : logs) sampled += l->entries.size();
+    std::vector<LineReport> reports = analyze(logs);
+
+    std::cout << "\n=== " << title << " (" << sampled <<  " sampled accesses, 1 in " << SAMPLE_EVERY
+              << "; per-thread counts are scaled estimates, invalidations are exact) ===" << std::endl;
+    if (reports.empty()) std::cout << "No cache line is written by one thread and used by another." << std::endl;
+    for (const LineReport& r : reports) {
+        std::cout << "Line 0x" << std::hex << r.line << std::dec << ": " << r.threads.size() << " threads, "
+                  << (r.false_sharing ? "FALSE SHARING (disjoint bytes - pad or separate them)"
+                                      : "TRUE SHARING (same bytes - needs a different algorithm, not padding)")
+                  << ", " << r.invalidations << " invalidations" << std::endl;
+        for (const auto& [tid, u] : r.threads) {
+            std::cout << "    thread " << tid << ": " << std::setw(7) << u.writes * SAMPLE_EVERY << " writes "
+                      << std::setw(7) << byte_range(u.write_mask) << ", " << std::setw(7) << u.reads * SAMPLE_EVERY
+                      << " reads " << std::setw(7) << byte_range(u.read_mask);
+            for (uintptr_t a : u.write_addrs) std::cout << "   " << symbols.describe(a);
+            std::cout << std::endl;
+        }
+    }
+    AccessRecorder::instance().clear();
+}
+
+// --- Workloads (from 13_false_sharing.cpp, with std::atomic -> Tracked) ---
+
+struct Counters {
+    alignas(64) Tracked<long long> CounterA = 0;
+    Tracked<long long> CounterB = 0; // Same cache line as CounterA
+};
+
+struct PaddedCounters {
+    alignas(cache_line_size) Tracked<long long> CounterA = 0;
+    char padding[cache_line_size - sizeof(Tracked<long long>)];
+    alignas(cache_line_size) Tracked<long long> CounterB = 0;
+};
+
+const long long ITERATIONS = 2'000'000;
+
+void worker(Tracked<long long>& counter) {
+    for (long long i = 0; i < ITERATIONS; ++i) counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename Fn>
+double run_threads(int n, Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> ts;
+    for (int i = 0; i < n; ++i) ts.emplace_back(fn, i);
+    for (auto& t : ts) t.join();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+    std::cout << "--- False-Sharing Detector (cache line " << cache_line_size << " bytes) ---" << std::endl;
+    SymbolTable symbols;
+
+    Counters counters_unpadded;
+    symbols.add_object("counters_unpadded", &counters_unpadded, sizeof(Counters),
+                       {FS_FIELD(Counters, CounterA), FS_FIELD(Counters, CounterB)});
+    double ms = run_threads(2, [&](int i) { worker(i == 0 ? counters_unpadded.CounterA : counters_unpadded.CounterB); });
+    print_report("Counters (unpadded), " + std::to_string(ms) + " ms", symbols);
+
+    PaddedCounters counters_padded;
+    symbols.add_object("counters_padded", &counters_padded, sizeof(PaddedCounters),
+                       {FS_FIELD(PaddedCounters, CounterA), FS_FIELD(PaddedCounters, padding),
+                        FS_FIELD(PaddedCounters, CounterB)});
+    ms = run_threads(2, [&](int i) { worker(i == 0 ? counters_padded.CounterA : counters_padded.CounterB); });
+    print_report("PaddedCounters, " + std::to_string(ms) + " ms", symbols);
+
+    // Common in real code: one slot per thread in a plain array, 8 slots per cache line
+    const int THREADS = 4;
+    std::vector<Tracked<long long>> slots(THREADS);
+    symbols.add_array("per_thread_slots", slots.data(), slots.size(), sizeof(Tracked<long long>));
+    ms = run_threads(THREADS, [&](int i) { worker(slots[i]); });
+    print_report("std::vector<atomic> slot per thread, " + std::to_string(ms) + " ms", symbols);
+
+    // Control: every thread increments the same counter - contended, but padding cannot help
+    Tracked<long long> shared_total = 0;
+    symbols.add_object("shared_total", &shared_total, sizeof(shared_total));
+    ms = run_threads(2, [&](int) { worker(shared_total); });
+    print_report("Single shared counter, " + std::to_string(ms) + " ms", symbols);
+
+    std::cout << "\nResults: unpadded A=" << counters_unpadded.CounterA << " B=" << counters_unpadded.CounterB
+              << ", padded A=" << counters_padded.CounterA << " B=" << counters_padded.CounterB
+              << ", shared=" << shared_total << std::endl;
+    return 0;
+}
+// Compile with: g++ 29_false_sharing_detector.cpp -o bin/false_sharing_detector -pthread -std=c++17 -O2
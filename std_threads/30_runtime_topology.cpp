@@ -0,0 +1,457 @@
+// Runtime Cache and CPU Topology Detection (sysfs + cpuid), driving padding, tiling, grain size and pinning
+// Concept: 13_false_sharing.cpp falls back to cache_line_size = 64 and several kernels hard-code 16-byte
+// alignment or tile sizes. Those are guesses made at compile time for an unknown machine. The real values are
+// available at run time:
+//   sysfs:  /sys/devices/system/cpu/cpuN/cache/indexK/{level,type,size,coherency_line_size,shared_cpu_list},
+//           .../topology/{thread_siblings_list,core_id,physical_package_id}, /sys/devices/system/node/nodeN/cpulist
+//   cpuid:  leaf 4 (Intel) / 0x8000001D (AMD) deterministic cache parameters, leaf 1 CLFLUSH line size
+//   libc:   sched_getaffinity (the CPUs this process may actually use, e.g. inside a container cpuset)
+// From the Topology we derive a Tuning: per-thread slot stride (padding), matrix tile sizes from L1/L2,
+// parallel-for grain size from L2, and a worker pinning order (one thread per physical core first, spread over
+// L3 domains / NUMA nodes, SMT siblings last). Tile and grain choices are benchmarked against fixed constants.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+// --- Topology model ---
+struct CacheLevel {
+    int level = 0;
+    std::string type;      // "Data", "Instruction", "Unified"
+    size_t size = 0;       // Bytes
+    size_t line_size = 0;  // Bytes
+    int ways = 0;
+    std::vector<int> shared_cpus; // CPUs sharing this cache instance (from cpu0's view)
+};
+
+struct Topology {
+    size_t line_size = 64;
+    std::vector<CacheLevel> caches;           // As seen by the first usable CPU
+    std::vector<int> cpus;                    // CPUs this process may run on
+    std::map<int, std::vector<int>> siblings; // CPU -> SMT siblings (including itself)
+    std::vector<std::vector<int>> l3_domains; // CPUs per last-level cache instance
+    std::vector<std::vector<int>> numa_nodes; // CPUs per NUMA node
+    std::string source;                       // Where the cache data came from
+
+    size_t cache_bytes(int level) const { // Data or unified cache at `level`, 0 if unknown
+        for (const CacheLevel& c : caches)
+            if (c.level == level && c.type != "Instruction") return c.size;
+        return 0;
+    }
+    size_t physical_cores() const {
+        std::set<std::vector<int>> cores;
+        for (int cpu : cpus) cores.insert(siblings.count(cpu) ? siblings.at(cpu) : std::vector<int>{cpu});
+        return cores.size();
+    }
+};
+
+// --- sysfs helpers ---
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::getline(in, out);
+    return true;
+}
+
+std::vector<int> parse_cpu_list(const std::string& s) { // "0-3,8,10-11"
+    std::vector<int> cpus;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty()) continue;
+        size_t dash = part.find('-');
+        int lo = std::stoi(part.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+size_t parse_size(const std::string& s) { // "48K", "2048K", "300M"
+    size_t v = std::stoul(s);
+    if (s.find('K') != std::string::npos) v <<= 10;
+    else if (s.find('M') != std::string::npos) v <<= 20;
+    else if (s.find('G') != std::string::npos) v <<= 30;
+    return v;
+}
+
+std::vector<CacheLevel> caches_from_sysfs(int cpu) {
+    std::vector<CacheLevel> caches;
+    for (int idx = 0;; ++idx) {
+        const std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(idx) + "/";
+        std::string level, type, size, line, ways, shared;
+        if (!read_file(dir + "level", level) || !read_file(dir + "type", type) || !read_file(dir + "size", size)) break;
+        CacheLevel c;
+        c.level = std::stoi(level);
+        c.type = type;
+        c.size = parse_size(size);
+        if (read_file(dir + "coherency_line_size", line)) c.line_size = std::stoul(line);
+        if (read_file(dir + "ways_of_associativity", ways)) c.ways = std::stoi(ways);
+        if (read_file(dir + "shared_cpu_list", shared)) c.shared_cpus = parse_cpu_list(shared);
+        caches.push_back(c);
+    }
+    return caches;
+}
+
+// --- cpuid fallback: deterministic cache parameters ---
+std::vector<CacheLevel> caches_from_cpuid() {
+    std::vector<CacheLevel> caches;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return caches;
+    const bool amd = ebx == 0x68747541; // "Auth"enticAMD
+    const unsigned leaf = amd ? 0x8000001D : 4;
+    for (unsigned sub = 0; sub < 16; ++sub) {
+        __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+        const unsigned type = eax & 0x1F;
+        if (type == 0) break; // No more caches
+        CacheLevel c;
+        c.level = (eax >> 5) & 0x7;
+        c.type = type == 1 ? "Data" : type == 2 ? "Instruction" : "Unified";
+        c.line_size = (ebx & 0xFFF) + 1;
+        const size_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+        c.ways = int(((ebx >> 22) & 0x3FF) + 1);
+        c.size = size_t(c.ways) * partitions * c.line_size * (size_t(ecx) + 1);
+        caches.push_back(c);
+    }
+#endif
+    return caches;
+}
+
+size_t line_size_from_cpuid() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return ((ebx >> 8) & 0xFF) * 8; // CLFLUSH line size
+#endif
+    return 0;
+}
+
+Topology detect_topology() {
+    Topology t;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) t.cpus.push_back(c);
+    }
+    if (t.cpus.empty()) {
+        for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); ++c) t.cpus.push_back(int(c));
+    }
+
+    t.caches = caches_from_sysfs(t.cpus[0]);
+    t.source = "sysfs";
+    if (t.caches.empty()) {
+        t.caches = caches_from_cpuid();
+        t.source = "cpuid";
+    }
+    if (t.caches.empty()) {
+        long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE), l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (l1 > 0) t.caches.push_back({1, "Data", size_t(l1), 0, 0, {}});
+        if (l2 > 0) t.caches.push_back({2, "Unified", size_t(l2), 0, 0, {}});
+        t.source = "sysconf";
+    }
+
+    // Line size: the L1 data cache's, else CLFLUSH size, else sysconf, else the classic guess
+    size_t line = 0;
+    for (const CacheLevel& c : t.caches)
+        if (c.level == 1 && c.type != "Instruction" && c.line_size) line = c.line_size;
+    if (!line) line = line_size_from_cpuid();
+    if (!line) {
+        long v = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        line = v > 0 ? size_t(v) : 64;
+    }
+    t.line_size = line;
+
+    // SMT siblings and last-level cache domains, per usable CPU
+    std::set<std::vector<int>> llc;
+    int llc_level = 0;
+    for (const CacheLevel& c : t.caches) llc_level = std::max(llc_level, c.level);
+    for (int cpu : t.cpus) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        std::string s;
+        t.siblings[cpu] = read_file(base + "/topology/thread_siblings_list", s) ? parse_cpu_list(s) : std::vector<int>{cpu};
+        for (const CacheLevel& c : caches_from_sysfs(cpu))
+            if (c.level == llc_level && c.type != "Instruction" && !c.shared_cpus.empty()) llc.insert(c.shared_cpus);
+    }
+    t.l3_domains.assign(llc.begin(), llc.end());
+    if (t.l3_domains.empty()) t.l3_domains.push_back(t.cpus);
+
+    for (int node = 0; node < 1024; ++node) {
+        std::string s;
+        if (!read_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", s)) {
+            if (node > 0 || !t.numa_nodes.empty()) break;
+            continue;
+        }
+        std::vector<int> cpus = parse_cpu_list(s);
+        if (!cpus.empty()) t.numa_nodes.push_back(cpus);
+    }
+    if (t.numa_nodes.empty()) t.numa_nodes.push_back(t.cpus);
+    return t;
+}
+
+// --- Tuning derived from the topology ---
+struct Tuning {
+    size_t slot_stride;      // Bytes between per-thread mutable slots
+    size_t transpose_tile;   // Square tile whose source and destination blocks fit in L1
+    size_t matmul_tile;      // Square tile: 3 float tiles (A, B, C blocks) fit in half of L2
+    size_t grain_elems;      // Floats per parallel-for task: about half of L2 per task
+    std::vector<int> pin_order;
+};
+
+size_t floor_pow2(size_t x) {
+    size_t p = 1;
+    while (p * 2 <= x) p *= 2;
+    return p;
+}
+
+// Worker i goes to pin_order[i % size]: first one CPU per physical core, round-robin over L3 domains (which
+// also spreads over NUMA nodes), then the remaining SMT siblings in the same order.
+std::vector<int> make_pin_order(const Topology& t) {
+    std::vector<std::vector<int>> primaries(t.l3_domains.size()), secondaries(t.l3_domains.size());
+    std::set<int> usable(t.cpus.begin(), t.cpus.end()), placed;
+    for (size_t d = 0; d < t.l3_domains.size(); ++d) {
+        for (int cpu : t.l3_domains[d]) {
+            if (!usable.count(cpu) || placed.count(cpu)) continue;
+            const std::vector<int>& sib = t.siblings.count(cpu) ? t.siblings.at(cpu) : std::vector<int>{cpu};
+            bool first = true;
+            for (int s : sib) {
+                if (!usable.count(s) || placed.count(s)) continue;
+                (first ? primaries : secondaries)[d].push_back(s);
+                placed.insert(s);
+                first = false;
+            }
+        }
+    }
+    std::vector<int> order;
+    for (auto* group : {&primaries, &secondaries}) {
+        for (size_t i = 0;; ++i) {
+            bool any = false;
+            for (auto& domain : *group)
+                if (i < domain.size()) { order.push_back(domain[i]); any = true; }
+            if (!any) break;
+        }
+    }
+    for (int cpu : t.cpus) // CPUs missing from every L3 list (incomplete sysfs)
+        if (!placed.count(cpu)) order.push_back(cpu);
+    return order;
+}
+
+Tuning derive_tuning(const Topology& t) {
+    Tuning tu;
+    tu.slot_stride = t.line_size;
+    const size_t l1 = t.cache_bytes(1) ? t.cache_bytes(1) : 32u << 10;
+    const size_t l2 = t.cache_bytes(2) ? t.cache_bytes(2) : 256u << 10;
+    tu.transpose_tile = std::max<size_t>(8, floor_pow2(size_t(std::sqrt(double(l1) / (2 * sizeof(float))))));
+    tu.matmul_tile = std::max<size_t>(16, size_t(std::sqrt(double(l2) / 2 / (3 * sizeof(float)))) / 16 * 16);
+    tu.grain_elems = std::max<size_t>(1024, l2 / 2 / sizeof(float));
+    tu.pin_order = make_pin_order(t);
+    return tu;
+}
+
+// --- Consumers ---
+
+// Per-thread slots spaced by a stride chosen at run time (alignas needs a compile-time constant)
+template<typename T>
+class StridedSlots {
+public:
+    StridedSlots(size_t count, size_t stride) : stride_(std::max(stride, sizeof(T))), count_(count) {
+        const size_t align = std::max<size_t>(alignof(T), std::min<size_t>(stride_, 4096));
+        base_ = static_cast<char*>(std::aligned_alloc(align, (count * stride_ + align - 1) / align * align));
+        if (!base_) throw std::bad_alloc();
+        for (size_t i = 0; i < count; ++i) new (base_ + i * stride_) T();
+    }
+    ~StridedSlots() {
+        for (size_t i = 0; i < count_; ++i) (*this)[i].~T();
+        std::free(base_);
+    }
+    T& operator[](size_t i) { return *reinterpret_cast<T*>(base_ + i * stride_); }
+
+private:
+    size_t stride_, count_;
+    char* base_;
+};
+
+void pin_current_thread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Threads pull `grain`-sized ranges from a shared counter; workers pinned in topology order when given one
+template<typename Fn>
+void parallel_for(size_t n, size_t grain, int threads, const std::vector<int>& pin_order, Fn fn) {
+    std::atomic<size_t> next{0};
+    auto work = [&](int id) {
+        if (!pin_order.empty()) pin_current_thread(pin_order[id % pin_order.size()]);
+        for (size_t b; (b = next.fetch_add(grain, std::memory_order_relaxed)) < n;) fn(b, std::min(n, b + grain));
+    };
+    std::vector<std::thread> ts;
+    for (int i = 1; i < threads; ++i) ts.emplace_back(work, i);
+    work(0);
+    for (auto& th : ts) th.join();
+}
+
+void transpose_blocked(const float* in, float* out, size_t n, size_t tile) {
+    for (size_t ii = 0; ii < n; ii += tile)
+        for (size_t jj = 0; jj < n; jj += tile)
+            for (size_t i = ii; i < std::min(n, ii + tile); ++i)
+                for (size_t j = jj; j < std::min(n, jj + tile); ++j) out[j * n + i] = in[i * n + j];
+}
+
+void matmul_blocked(const float* a, const float* b, float* c, size_t n, size_t tile) {
+    std::fill(c, c + n * n, 0.0f);
+    for (size_t ii = 0; ii < n; ii += tile)
+        for (size_t kk = 0; kk < n; kk += tile)
+            for (size_t jj = 0; jj < n; jj += tile) {
+                const size_t ie = std::min(n, ii + tile), ke = std::min(n, kk + tile), je = std::min(n, jj + tile);
+                for (size_t i = ii; i < ie; ++i)
+                    for (size_t k = kk; k < ke; ++k) {
+                        const float aik = a[i * n + k];
+                        for (size_t j = jj; j < je; ++j) c[i * n + j] += aik * b[k * n + j];
+                    }
+            }
+}
+
+// --- Benchmarks ---
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Fn>
+double best_ms(int reps, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+std::string cpu_list_string(const std::vector<int>& cpus) {
+    std::string s;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!s.empty()) s += ",";
+        s += std::to_string(cpus[i]) + (j > i ? "-" + std::to_string(cpus[j]) : "");
+        i = j;
+    }
+    return s;
+}
+
+void print_topology(const Topology& t, const Tuning& tu) {
+    std::cout << "Usable CPUs: " << cpu_list_string(t.cpus) << " (" << t.cpus.size() << " logical, "
+              << t.physical_cores() << " physical cores)" << std::endl;
+    std::cout << "Cache line: " << t.line_size << " bytes";
+#ifdef __cpp_lib_hardware_interference_size
+    std::cout << " (compile-time hardware_destructive_interference_size: " << std::hardware_destructive_interference_size << ")";
+#else
+    std::cout << " (compile-time hardware_destructive_interference_size: unavailable, code guesses 64)";
+#endif
+    std::cout << std::endl << "Caches (" << t.source << "):" << std::endl;
+    for (const CacheLevel& c : t.caches) {
+        std::cout << "  L" << c.level << " " << std::left << std::setw(12) << c.type << std::right << std::setw(8)
+                  << (c.size >> 10) << " KiB, line " << c.line_size << ", " << c.ways << "-way";
+        if (!c.shared_cpus.empty()) std::cout << ", shared by CPUs " << cpu_list_string(c.shared_cpus);
+        std::cout << std::endl;
+    }
+    std::cout << "Last-level cache domains: " << t.l3_domains.size();
+    for (const auto& d : t.l3_domains) std::cout << " [" << cpu_list_string(d) << "]";
+    std::cout << std::endl << "NUMA nodes: " << t.numa_nodes.size();
+    for (const auto& d : t.numa_nodes) std::cout << " [" << cpu_list_string(d) << "]";
+    std::cout << std::endl;
+    std::cout << "\nDerived tuning: slot stride " << tu.slot_stride << " B, transpose tile " << tu.transpose_tile
+              << ", matmul tile " << tu.matmul_tile << ", grain " << tu.grain_elems << " floats, pin order ";
+    for (size_t i = 0; i < std::min<size_t>(tu.pin_order.size(), 16); ++i) std::cout << (i ? "," : "") << tu.pin_order[i];
+    if (tu.pin_order.size() > 16) std::cout << ",...";
+    std::cout << std::endl;
+}
+
+int main() {
+    std::cout << "--- Runtime Topology Detection ---" << std::endl;
+    const Topology topo = detect_topology();
+    const Tuning tuning = derive_tuning(topo);
+    print_topology(topo, tuning);
+
+    const int threads = std::max<int>(2, int(topo.cpus.size()));
+
+    // 1. Padding: per-thread counters packed (8 B apart) vs spaced by the detected line size
+    std::cout << "\nPer-thread counters, " << threads << " threads x 20M relaxed increments" << std::endl;
+    for (size_t stride : {sizeof(std::atomic<long>), tuning.slot_stride}) {
+        StridedSlots<std::atomic<long>> slots(threads, stride);
+        double ms = best_ms(1, [&] {
+            parallel_for(threads, 1, threads, tuning.pin_order, [&](size_t b, size_t) {
+                for (int i = 0; i < 20'000'000; ++i) slots[b].fetch_add(1, std::memory_order_relaxed);
+            });
+        });
+        std::cout << "  stride " << std::setw(3) << stride << " B: " << std::fixed << std::setprecision(1) << ms
+                  << " ms" << (stride == tuning.slot_stride ? "   <- runtime line size" : "") << std::endl;
+    }
+
+    // 2. Tiling: fixed tile constants vs the tile derived from the cache sizes
+    const size_t TN = 4096;
+    std::vector<float> in(TN * TN), out(TN * TN);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = float(i % 1000);
+    std::cout << "\nTranspose " << TN << "x" << TN << " floats (tile from L1: " << tuning.transpose_tile << ")" << std::endl;
+    std::vector<size_t> tiles = {4, 8, 16, 32, 64, 128, 256};
+    if (std::find(tiles.begin(), tiles.end(), tuning.transpose_tile) == tiles.end()) tiles.push_back(tuning.transpose_tile);
+    for (size_t tile : tiles) {
+        double ms = best_ms(3, [&] { transpose_blocked(in.data(), out.data(), TN, tile); });
+        std::cout << "  tile " << std::setw(4) << tile << ": " << std::setw(7) << ms << " ms, "
+                  << std::setw(5) << std::setprecision(2) << 2.0 * TN * TN * sizeof(float) / ms / 1e6 << " GB/s"
+                  << std::setprecision(1) << (tile == tuning.transpose_tile ? "   <- runtime" : "") << std::endl;
+    }
+
+    const size_t MN = 768;
+    std::vector<float> a(MN * MN), b(MN * MN), c(MN * MN);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = float(i % 7) * 0.5f; b[i] = float(i % 5) * 0.25f; }
+    std::cout << "\nMatmul " << MN << "x" << MN << " (tile from L2: " << tuning.matmul_tile << ")" << std::endl;
+    tiles = {16, 32, 64, 128, 256, MN};
+    if (std::find(tiles.begin(), tiles.end(), tuning.matmul_tile) == tiles.end()) tiles.push_back(tuning.matmul_tile);
+    for (size_t tile : tiles) {
+        double ms = best_ms(1, [&] { matmul_blocked(a.data(), b.data(), c.data(), MN, tile); });
+        std::cout << "  tile " << std::setw(4) << tile << ": " << std::setw(7) << ms << " ms, " << std::setw(5)
+                  << 2.0 * MN * MN * MN / ms / 1e6 << " GFLOP/s"
+                  << (tile == tuning.matmul_tile ? "   <- runtime" : tile == MN ? "   (untiled)" : "") << std::endl;
+    }
+
+    // 3. Grain size: parallel a[i] = a[i] * s + 1 over 64M floats
+    std::vector<float> data(64u << 20, 1.0f);
+    std::cout << "\nParallel scale over " << (data.size() >> 20) << "M floats, " << threads
+              << " pinned threads (grain from L2: " << tuning.grain_elems << ")" << std::endl;
+    std::vector<size_t> grains = {256, 4096, 65536, 1u << 20, data.size() / threads};
+    if (std::find(grains.begin(), grains.end(), tuning.grain_elems) == grains.end()) grains.push_back(tuning.grain_elems);
+    std::sort(grains.begin(), grains.end());
+    for (size_t grain : grains) {
+        double ms = best_ms(3, [&] {
+            parallel_for(data.size(), grain, threads, tuning.pin_order, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) data[i] = data[i] * 0.999f + 1.0f;
+            });
+        });
+        std::cout << "  grain " << std::setw(9) << grain << ": " << std::setw(7) << ms << " ms"
+                  << (grain == tuning.grain_elems ? "   <- runtime" : "") << std::endl;
+    }
+    return 0;
+}
+// Compile with: g++ 30_runtime_topology.cpp -o bin/runtime_topology -pthread -std=c++17 -O2